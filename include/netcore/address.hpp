@@ -3,8 +3,12 @@
 #include <array>
 #include <filesystem>
 #include <fmt/core.h>
+#include <functional>
 #include <netdb.h>
+#include <netinet/in.h>
 #include <string_view>
+#include <sys/socket.h>
+#include <type_traits>
 #include <variant>
 
 namespace netcore {
@@ -13,7 +17,11 @@ namespace netcore {
     public:
         address() = default;
 
-        address(std::string_view host, std::string_view port);
+        address(
+            std::string_view host,
+            std::string_view port,
+            int type = SOCK_STREAM
+        );
 
         ~address();
 
@@ -26,6 +34,70 @@ namespace netcore {
 
     enum class ip_addr { ipv4, ipv6 };
 
+    // Raw peer address as returned by the kernel. Conversion to text is
+    // deferred until the address is formatted.
+    class peer_address {
+        sockaddr_storage storage;
+        socklen_t len = 0;
+
+        auto host_bytes() const noexcept -> std::string_view;
+    public:
+        using host_buffer = std::array<char, INET6_ADDRSTRLEN>;
+
+        peer_address() noexcept;
+
+        peer_address(const sockaddr* addr, socklen_t len) noexcept;
+
+        // Compares the family, host and port, ignoring padding and IPv6 flow
+        // information.
+        auto operator==(const peer_address& other) const noexcept -> bool;
+
+        auto capacity() const noexcept -> socklen_t;
+
+        auto data() const noexcept -> const sockaddr*;
+
+        auto data() noexcept -> sockaddr*;
+
+        auto empty() const noexcept -> bool;
+
+        auto family() const noexcept -> int;
+
+        auto hash() const noexcept -> std::size_t;
+
+        auto host(host_buffer& buffer) const noexcept -> std::string_view;
+
+        auto host_hash() const noexcept -> std::size_t;
+
+        auto path() const noexcept -> std::string_view;
+
+        auto port() const noexcept -> unsigned short;
+
+        auto resize(socklen_t len) noexcept -> void;
+
+        // Compares the family and host only, so that connections from the
+        // same host match regardless of their ports.
+        auto same_host(const peer_address& other) const noexcept -> bool;
+
+        auto size() const noexcept -> socklen_t;
+    };
+
+    // Keys unordered containers by peer host rather than by connection.
+    struct peer_host_equal {
+        auto operator()(const peer_address& a, const peer_address& b)
+            const noexcept -> bool {
+            return a.same_host(b);
+        }
+    };
+
+    struct peer_host_hash {
+        auto operator()(const peer_address& addr) const noexcept
+            -> std::size_t {
+            return addr.host_hash();
+        }
+    };
+
+    static_assert(std::is_trivially_copyable_v<peer_address>);
+
     class socket_addr {
         std::string host_;
         unsigned short port_;
@@ -70,6 +142,47 @@ struct fmt::formatter<netcore::address_type> {
     }
 };
 
+template <>
+struct std::hash<netcore::peer_address> {
+    auto operator()(const netcore::peer_address& addr) const noexcept
+        -> std::size_t {
+        return addr.hash();
+    }
+};
+
+template <>
+struct fmt::formatter<netcore::peer_address> {
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext& ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(const netcore::peer_address& addr, FormatContext& ctx) {
+        auto buffer = netcore::peer_address::host_buffer();
+
+        switch (addr.family()) {
+            case AF_INET:
+                return fmt::format_to(
+                    ctx.out(),
+                    "{}:{}",
+                    addr.host(buffer),
+                    addr.port()
+                );
+            case AF_INET6:
+                return fmt::format_to(
+                    ctx.out(),
+                    "[{}]:{}",
+                    addr.host(buffer),
+                    addr.port()
+                );
+            case AF_UNIX:
+                return fmt::format_to(ctx.out(), R"("{}")", addr.path());
+            default: return fmt::format_to(ctx.out(), "<no address>");
+        }
+    }
+};
+
 template <>
 struct fmt::formatter<netcore::socket_addr> {
     template <typename ParseContext>
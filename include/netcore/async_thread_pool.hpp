@@ -6,8 +6,6 @@ namespace netcore {
     class async_thread_pool {
         std::size_t current = 0;
         std::vector<std::unique_ptr<async_thread>> threads;
-
-        auto thread() noexcept -> async_thread&;
     public:
         async_thread_pool(
             int count,
@@ -17,6 +15,9 @@ namespace netcore {
 
         auto run(ext::task<>&& task) -> void;
 
+        // Returns the threads in turn.
+        auto thread() noexcept -> async_thread&;
+
         auto wait(ext::task<>&& task) -> ext::task<>;
 
         template <typename T>
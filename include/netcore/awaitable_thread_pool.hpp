@@ -1,14 +1,12 @@
 #pragma once
 
+#include "detail/awaiter.hpp"
 #include "eventfd.hpp"
 #include "thread_pool.hpp"
 
 namespace netcore {
     class awaitable_thread_pool {
-        struct node {
-            std::coroutine_handle<> coroutine;
-            node* next = nullptr;
-        };
+        using node = detail::awaiter;
 
         std::mutex mutex;
         eventfd event;
@@ -16,11 +14,14 @@ namespace netcore {
         node* tail = nullptr;
         thread_pool pool;
         ext::jtask<> task;
+        std::size_t outstanding = 0;
 
         auto enqueue(node& node) -> void;
 
         auto resume() -> void;
 
+        auto start() -> void;
+
         auto take_nodes() -> node*;
 
         auto wait_for_events() -> ext::jtask<>;
@@ -50,6 +51,7 @@ namespace netcore {
                     -> void {
                     node.coroutine = coroutine;
 
+                    pool.start();
                     pool.run([this]() -> void {
                         try {
                             f();
@@ -0,0 +1,352 @@
+#pragma once
+
+#include "client.hpp"
+#include "deadline.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <ext/scope>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <timber/timber>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace netcore {
+    enum class balance_strategy { least_outstanding, power_of_two };
+
+    struct balancer_options {
+        balance_strategy strategy = balance_strategy::power_of_two;
+        // Consecutive failures after which an endpoint stops receiving
+        // requests until the ejection time has passed.
+        unsigned int failure_threshold = 5;
+        std::chrono::milliseconds ejection_time = std::chrono::seconds(30);
+    };
+
+    template <client_connection T>
+    class balanced_client {
+        using clock = std::chrono::steady_clock;
+
+        struct backend {
+            std::string endpoint;
+            client<T> pool;
+            std::size_t outstanding = 0;
+            unsigned int failures = 0;
+            clock::time_point ejected_until;
+
+            backend(
+                std::string_view endpoint,
+                std::size_t buffer_size,
+                const connection_pool_options& pool_options,
+                const connect_options& connect
+            ) :
+                endpoint(endpoint),
+                pool(endpoint, buffer_size, pool_options, connect) {}
+        };
+
+        std::vector<std::shared_ptr<backend>> backends;
+        std::size_t buffer_size = 8192;
+        connection_pool_options pool_options;
+        connect_options connect_opts;
+        balancer_options options;
+        std::minstd_rand random;
+        deadline* maintenance = nullptr;
+        ext::counter maintainers;
+
+        // Holds the backend so that a removed endpoint's pool stays alive
+        // until its maintenance has stopped.
+        static auto maintain(
+            std::shared_ptr<backend> target,
+            ext::counter::guard guard
+        ) -> ext::detached_task {
+            const auto task = target->pool.maintain();
+            co_await task;
+        }
+
+        auto record(backend& b, bool failed) -> void {
+            if (!failed) {
+                b.failures = 0;
+                return;
+            }
+
+            if (++b.failures < options.failure_threshold) return;
+
+            b.failures = 0;
+            b.ejected_until = clock::now() + options.ejection_time;
+
+            TIMBER_WARNING(
+                "Ejecting endpoint \"{}\" for {:L}ms",
+                b.endpoint,
+                options.ejection_time.count()
+            );
+        }
+
+        auto select() -> std::shared_ptr<backend> {
+            if (backends.empty()) {
+                throw std::runtime_error("balanced client has no endpoints");
+            }
+
+            const auto now = clock::now();
+            std::size_t count = std::count_if(
+                backends.begin(),
+                backends.end(),
+                [now](const auto& b) { return b->ejected_until <= now; }
+            );
+
+            // With every endpoint ejected, load is spread over all of them
+            // rather than failing outright.
+            const auto all = count == 0;
+            if (all) count = backends.size();
+
+            const auto eligible = [all, now](const auto& b) {
+                return all || b->ejected_until <= now;
+            };
+
+            if (options.strategy == balance_strategy::least_outstanding) {
+                auto selected = std::shared_ptr<backend>();
+
+                for (const auto& b : backends) {
+                    if (!eligible(b)) continue;
+                    if (selected && selected->outstanding <= b->outstanding) {
+                        continue;
+                    }
+
+                    selected = b;
+                }
+
+                return selected;
+            }
+
+            const auto nth = [&](std::size_t n) -> std::shared_ptr<backend> {
+                for (const auto& b : backends) {
+                    if (eligible(b) && n-- == 0) return b;
+                }
+
+                return nullptr;
+            };
+
+            if (count == 1) return nth(0);
+
+            const auto first = std::uniform_int_distribution<std::size_t>(
+                0,
+                count - 1
+            )(random);
+            auto second = std::uniform_int_distribution<std::size_t>(
+                0,
+                count - 2
+            )(random);
+            if (second >= first) ++second;
+
+            auto a = nth(first);
+            auto b = nth(second);
+
+            return b->outstanding < a->outstanding ? b : a;
+        }
+    public:
+        using value_type = T;
+
+        class item {
+            friend class balanced_client;
+
+            balanced_client* owner = nullptr;
+            std::shared_ptr<backend> target;
+            typename client<T>::pool::item connection;
+
+            item(
+                balanced_client* owner,
+                std::shared_ptr<backend> target,
+                typename client<T>::pool::item&& connection
+            ) :
+                owner(owner),
+                target(std::move(target)),
+                connection(std::move(connection)) {}
+
+            auto release() -> void {
+                if (!owner) return;
+
+                --target->outstanding;
+                owner->record(*target, connection->failed());
+                owner = nullptr;
+            }
+        public:
+            item() = default;
+
+            item(const item&) = delete;
+
+            item(item&& other) :
+                owner(std::exchange(other.owner, nullptr)),
+                target(std::move(other.target)),
+                connection(std::move(other.connection)) {}
+
+            ~item() { release(); }
+
+            auto operator=(const item&) -> item& = delete;
+
+            auto operator=(item&& other) -> item& {
+                release();
+
+                // The previous connection must be returned while its pool is
+                // still kept alive by the previous target.
+                owner = std::exchange(other.owner, nullptr);
+                connection = std::move(other.connection);
+                target = std::move(other.target);
+
+                return *this;
+            }
+
+            auto operator*() const noexcept -> T& { return *connection; }
+
+            auto operator->() const noexcept -> T* {
+                return connection.operator->();
+            }
+
+            auto discard() -> void {
+                release();
+                connection.discard();
+            }
+
+            auto endpoint() const noexcept -> std::string_view {
+                return target->endpoint;
+            }
+        };
+
+        balanced_client() = default;
+
+        balanced_client(
+            std::span<const std::string> endpoints,
+            std::size_t buffer_size,
+            const balancer_options& options = {},
+            const connection_pool_options& pool_options = {},
+            const connect_options& connect = {}
+        ) :
+            buffer_size(buffer_size),
+            pool_options(pool_options),
+            connect_opts(connect),
+            options(options),
+            random(std::random_device()()) {
+            update(endpoints);
+        }
+
+        balanced_client(const balanced_client&) = delete;
+
+        balanced_client(balanced_client&&) = delete;
+
+        auto operator=(const balanced_client&) -> balanced_client& = delete;
+
+        auto operator=(balanced_client&&) -> balanced_client& = delete;
+
+        auto connect() -> ext::task<item> {
+            auto target = select();
+            ++target->outstanding;
+
+            auto connection = typename client<T>::pool::item();
+
+            try {
+                connection = co_await target->pool.connect();
+            }
+            catch (...) {
+                --target->outstanding;
+                record(*target, true);
+                throw;
+            }
+
+            co_return item(this, std::move(target), std::move(connection));
+        }
+
+        auto endpoints() const -> std::vector<std::string> {
+            auto result = std::vector<std::string>();
+            result.reserve(backends.size());
+
+            for (const auto& b : backends) result.push_back(b->endpoint);
+
+            return result;
+        }
+
+        // Maintains the pools of all endpoints, including those added
+        // later, until stop() is called.
+        auto maintain() -> ext::jtask<> {
+            auto stopped = deadline();
+            maintenance = &stopped;
+
+            const auto deferred = ext::scope_exit([this, &stopped] {
+                if (maintenance == &stopped) maintenance = nullptr;
+            });
+
+            for (const auto& b : backends) {
+                maintain(b, maintainers.increment());
+            }
+
+            [[maybe_unused]] const auto expired = co_await stopped.wait();
+            if (maintainers) co_await maintainers.await();
+        }
+
+        auto outstanding() const noexcept -> std::size_t {
+            std::size_t result = 0;
+            for (const auto& b : backends) result += b->outstanding;
+            return result;
+        }
+
+        auto stop() -> void {
+            if (auto* const stopped = std::exchange(maintenance, nullptr)) {
+                stopped->disarm();
+            }
+
+            for (const auto& b : backends) b->pool.stop();
+        }
+
+        // Endpoints that remain in the set keep their pools, and duplicates
+        // are ignored. Removed endpoints stay alive until their checked out
+        // connections are returned, after which their idle connections are
+        // closed.
+        auto update(std::span<const std::string> endpoints) -> void {
+            auto existing = std::unordered_map<
+                std::string_view,
+                std::shared_ptr<backend>>();
+            existing.reserve(backends.size());
+
+            for (const auto& b : backends) existing.emplace(b->endpoint, b);
+
+            auto added = std::unordered_set<std::string_view>();
+            auto next = std::vector<std::shared_ptr<backend>>();
+            next.reserve(endpoints.size());
+
+            for (const auto& endpoint : endpoints) {
+                if (!added.insert(endpoint).second) continue;
+
+                const auto it = existing.find(endpoint);
+
+                if (it != existing.end()) {
+                    next.push_back(std::move(it->second));
+                    existing.erase(it);
+                    continue;
+                }
+
+                next.push_back(std::make_shared<backend>(
+                    endpoint,
+                    buffer_size,
+                    pool_options,
+                    connect_opts
+                ));
+
+                if (maintenance) maintain(next.back(), maintainers.increment());
+            }
+
+            if (maintenance) {
+                for (const auto& [endpoint, removed] : existing) {
+                    removed->pool.stop();
+                }
+            }
+
+            backends = std::move(next);
+        }
+
+        auto warm() -> ext::task<> {
+            // The set of endpoints may change while connections are opened.
+            const auto targets = backends;
+            for (const auto& b : targets) co_await b->pool.warm();
+        }
+    };
+}
@@ -30,6 +30,8 @@ namespace netcore {
 
         auto clear() noexcept -> void;
 
+        auto compact() noexcept -> void;
+
         auto consume(std::size_t bytes) -> void;
 
         auto data() const noexcept -> std::span<const std::byte>;
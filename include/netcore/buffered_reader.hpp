@@ -1,8 +1,9 @@
 #pragma once
 
-#include "buffer.hpp"
 #include "except.hpp"
+#include "static_buffer.hpp"
 
+#include <cassert>
 #include <ext/coroutine>
 
 namespace netcore {
@@ -13,9 +14,9 @@ namespace netcore {
         { t.try_read(dest, len) } -> std::convertible_to<long>;
     };
 
-    template <source Source>
+    template <source Source, std::size_t Capacity = 0>
     class buffered_reader final {
-        netcore::buffer buffer;
+        buffer_type<Capacity> buffer;
         Source* source;
 
         auto read_bytes(std::byte* dest, std::size_t len) -> ext::task<> {
@@ -50,10 +51,15 @@ namespace netcore {
     public:
         buffered_reader(Source& source) : source(&source) {}
 
-        buffered_reader(Source& source, std::size_t capacity) :
+        buffered_reader(Source& source, std::size_t capacity)
+        requires(Capacity == 0) :
             buffer(capacity),
             source(&source) {}
 
+        auto capacity() const noexcept -> std::size_t {
+            return buffer.capacity();
+        }
+
         auto clear() noexcept -> void { buffer.clear(); }
 
         auto consume(std::size_t len) -> void { buffer.consume(len); }
@@ -82,6 +88,17 @@ namespace netcore {
             co_return buffer.data();
         }
 
+        auto peek(std::size_t len) -> ext::task<std::span<const std::byte>> {
+            assert(len <= buffer.capacity() && "peek exceeds buffer capacity");
+
+            while (buffer.size() < len) {
+                if (buffer.available() < len - buffer.size()) buffer.compact();
+                if (!co_await fill_buffer()) throw eof();
+            }
+
+            co_return buffer.data().first(len);
+        }
+
         auto read() -> ext::task<std::span<const std::byte>> {
             if (buffer.empty()) co_await fill_buffer();
             co_return buffer.read();
@@ -2,7 +2,9 @@
 
 #include "buffered_reader.hpp"
 #include "buffered_writer.hpp"
+#include "connect.hpp"
 #include "endpoint.hpp"
+#include "file_cache.hpp"
 #include "socket.h"
 
 namespace netcore {
@@ -12,9 +14,18 @@ namespace netcore {
         socket inner;
         buffered_reader<socket> reader;
         buffered_writer<socket> writer;
+        bool corked = false;
+        bool corkable = true;
+
+        auto cork() -> void;
+
+        auto uncork() -> void;
     public:
-        static auto connect(const endpoint& endpoint, std::size_t buffer_size)
-            -> ext::task<buffered_socket>;
+        static auto connect(
+            const endpoint& endpoint,
+            std::size_t buffer_size,
+            const connect_options& options = {}
+        ) -> ext::task<buffered_socket>;
 
         buffered_socket();
 
@@ -24,10 +35,16 @@ namespace netcore {
 
         auto operator=(buffered_socket&& other) -> buffered_socket&;
 
+        auto await_writable() -> ext::task<>;
+
         auto await_write() -> ext::task<>;
 
+        auto buffered() const noexcept -> std::size_t;
+
         auto cancel() noexcept -> void;
 
+        auto capacity() const noexcept -> std::size_t;
+
         auto connected() -> bool;
 
         auto consume(std::size_t len) -> void;
@@ -42,6 +59,8 @@ namespace netcore {
 
         auto peek() -> ext::task<std::span<const std::byte>>;
 
+        auto peek(std::size_t len) -> ext::task<std::span<const std::byte>>;
+
         auto read() -> ext::task<std::span<const std::byte>>;
 
         auto read(std::size_t len) -> ext::task<std::span<const std::byte>>;
@@ -51,9 +70,29 @@ namespace netcore {
         auto sendfile(const netcore::fd& descriptor, std::size_t count)
             -> ext::task<>;
 
+        auto sendfile(
+            const netcore::fd& descriptor,
+            std::size_t offset,
+            std::size_t count
+        ) -> ext::task<>;
+
+        auto sendfile(
+            const std::filesystem::path& path,
+            std::size_t offset,
+            std::size_t count
+        ) -> ext::task<>;
+
         auto try_write(const void* src, std::size_t len) -> std::size_t;
 
+        auto try_writev(const iovec* iov, std::size_t count) -> long;
+
+        auto watermarks(std::size_t low, std::size_t high) -> void;
+
+        auto writable() const noexcept -> bool;
+
         auto write(const void* src, std::size_t len) -> ext::task<>;
+
+        auto zerocopy(std::size_t threshold) -> bool;
     };
 }
 
@@ -1,8 +1,10 @@
 #pragma once
 
-#include "buffer.hpp"
+#include "static_buffer.hpp"
 
 #include <ext/coroutine>
+#include <fmt/format.h>
+#include <stdexcept>
 
 namespace netcore {
     template <typename T>
@@ -14,10 +16,19 @@ namespace netcore {
         { t.write(src, len) } -> std::same_as<ext::task<std::size_t>>;
     };
 
-    template <sink Sink>
+    template <typename T>
+    concept zerocopy_sink =
+        sink<T> && requires(T t, const void* src, std::size_t len) {
+            { t.write_zerocopy(src, len) } -> std::same_as<ext::task<>>;
+        };
+
+    template <sink Sink, std::size_t Capacity = 0>
     class buffered_writer final {
-        netcore::buffer buffer;
+        buffer_type<Capacity> buffer;
         Sink* sink;
+        std::size_t zerocopy_threshold = 0;
+        std::size_t low_watermark = 0;
+        std::size_t high_watermark = 0;
 
         auto try_write_bytes(const std::byte* src, std::size_t len)
             -> std::size_t {
@@ -45,7 +56,20 @@ namespace netcore {
             return total;
         }
 
+        auto write_chunk() -> ext::task<> {
+            const auto chunk = buffer.data();
+            buffer.consume(co_await sink->write(chunk.data(), chunk.size()));
+        }
+
         auto write_bytes(const std::byte* src, std::size_t len) -> ext::task<> {
+            if constexpr (zerocopy_sink<Sink>) {
+                if (zerocopy_threshold > 0 && len >= zerocopy_threshold) {
+                    co_await flush();
+                    co_await sink->write_zerocopy(src, len);
+                    co_return;
+                }
+            }
+
             if (len >= buffer.capacity()) {
                 co_await flush();
 
@@ -71,16 +95,25 @@ namespace netcore {
     public:
         buffered_writer(Sink& sink) : sink(&sink) {}
 
-        buffered_writer(Sink& sink, std::size_t capacity) :
+        buffered_writer(Sink& sink, std::size_t capacity)
+        requires(Capacity == 0) :
             buffer(capacity),
             sink(&sink) {}
 
+        auto await_writable() -> ext::task<> {
+            while (!try_flush() && buffer.size() > low_watermark) {
+                co_await write_chunk();
+            }
+        }
+
         auto await_write() -> ext::task<> { return sink->await_write(); }
 
+        auto buffered() const noexcept -> std::size_t { return buffer.size(); }
+
         auto clear() -> void { buffer.clear(); }
 
         auto flush() -> ext::task<> {
-            while (!try_flush()) co_await sink->await_write();
+            while (!try_flush()) co_await write_chunk();
         }
 
         auto try_flush() -> bool {
@@ -103,10 +136,35 @@ namespace netcore {
             );
         }
 
+        auto watermarks(std::size_t low, std::size_t high) -> void {
+            if (low > high || high > buffer.capacity()) {
+                throw std::invalid_argument(fmt::format(
+                    "invalid watermarks [{:L}, {:L}] for buffer capacity {:L}",
+                    low,
+                    high,
+                    buffer.capacity()
+                ));
+            }
+
+            low_watermark = low;
+            high_watermark = high;
+        }
+
+        auto writable() const noexcept -> bool {
+            return buffer.size() <
+                   (high_watermark == 0 ? buffer.capacity() : high_watermark);
+        }
+
         auto write(const void* src, std::size_t len) -> ext::task<> {
             return write_bytes(reinterpret_cast<const std::byte*>(src), len);
         }
 
         auto write_to(Sink& sink) noexcept -> void { this->sink = &sink; }
+
+        auto zerocopy(std::size_t threshold) noexcept -> void
+        requires zerocopy_sink<Sink>
+        {
+            zerocopy_threshold = threshold;
+        }
     };
 }
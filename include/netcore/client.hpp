@@ -1,53 +1,94 @@
 #pragma once
 
 #include "buffered_socket.hpp"
+#include "connection_pool.hpp"
 
 #include <ext/pool>
 
 namespace netcore {
-    template <std::constructible_from<buffered_socket> T>
-    requires requires(T t) {
-        { t.connected() } -> std::same_as<bool>;
-        { t.failed() } -> std::same_as<bool>;
-    }
+    template <typename T>
+    concept client_connection =
+        std::constructible_from<T, buffered_socket> && requires(T t) {
+            { t.connected() } -> std::same_as<bool>;
+            { t.failed() } -> std::same_as<bool>;
+        };
+
+    template <client_connection T>
     struct client {
         class provider {
             netcore::endpoint endpoint;
             std::size_t buffer_size = 0;
+            connect_options options;
         public:
             provider() = default;
 
-            provider(std::string_view endpoint, std::size_t buffer_size) :
+            provider(
+                std::string_view endpoint,
+                std::size_t buffer_size,
+                const connect_options& options = {}
+            ) :
                 endpoint(parse_endpoint(endpoint)),
-                buffer_size(buffer_size) {}
+                buffer_size(buffer_size),
+                options(options) {}
 
             auto checkin(T& t) -> bool { return !t.failed(); }
 
             auto checkout(T& t) -> bool { return t.connected(); }
 
             auto provide() -> ext::task<T> {
-                co_return T {
-                    co_await buffered_socket::connect(endpoint, buffer_size)};
+                co_return T {co_await buffered_socket::connect(
+                    endpoint,
+                    buffer_size,
+                    options
+                )};
             }
         };
 
-        using pool = ext::pool<provider>;
+        using pool = connection_pool<provider>;
+        using value_type = T;
 
         client() = default;
 
         client(std::string_view endpoint) :
-            storage(ext::pool_options(), endpoint, 8192) {}
+            storage(connection_pool_options(), endpoint, 8192) {}
+
+        client(
+            std::string_view endpoint,
+            std::size_t buffer_size,
+            const connection_pool_options& options = {},
+            const connect_options& connect = {}
+        ) :
+            storage(options, endpoint, buffer_size, connect) {}
 
+        // Accepts the options of the generic pool that clients used before.
+        template <std::same_as<ext::pool_options> Options>
+        [[deprecated("use connection_pool_options")]]
         client(
             std::string_view endpoint,
             std::size_t buffer_size,
-            const ext::pool_options& options = {}
+            const Options& options,
+            const connect_options& connect = {}
         ) :
-            storage(options, endpoint, buffer_size) {}
+            client(
+                endpoint,
+                buffer_size,
+                connection_pool_options {.max_size = options.max_size},
+                connect
+            ) {}
 
         auto connect() -> ext::task<typename pool::item> {
             return storage.checkout();
         }
+
+        auto maintain() -> ext::jtask<> { return storage.maintain(); }
+
+        auto metrics() const noexcept -> const connection_pool_metrics& {
+            return storage.metrics();
+        }
+
+        auto stop() -> void { storage.stop(); }
+
+        auto warm() -> ext::task<> { return storage.warm(); }
     private:
         pool storage;
     };
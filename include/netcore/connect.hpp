@@ -3,11 +3,46 @@
 #include <netcore/endpoint.hpp>
 #include <netcore/socket.h>
 
+#include <chrono>
+#include <optional>
+
 namespace netcore {
-    auto connect(std::string_view host, std::string_view port)
+    class resolver;
+
+    struct connect_options {
+        std::chrono::milliseconds attempt_delay =
+            std::chrono::milliseconds(250);
+        // Defaults to the runtime's resolver.
+        netcore::resolver* resolver = nullptr;
+        std::optional<std::chrono::milliseconds> timeout;
+    };
+
+    auto connect(
+        std::string_view host,
+        std::string_view port,
+        const connect_options& options = {}
+    ) -> ext::task<socket>;
+
+    auto connect(std::string_view path, const connect_options& options = {})
+        -> ext::task<socket>;
+
+    auto connect(const endpoint& endpoint, const connect_options& options = {})
         -> ext::task<socket>;
 
-    auto connect(std::string_view path) -> ext::task<socket>;
+    // Sends 'data' with the SYN where TCP Fast Open allows, and otherwise
+    // as soon as the connection is established. As with any data sent in a
+    // SYN, it may be delivered more than once, including to addresses that
+    // lose the connection race, so it must be safe to replay.
+    auto connect_with_data(
+        std::string_view host,
+        std::string_view port,
+        std::span<const std::byte> data,
+        const connect_options& options = {}
+    ) -> ext::task<socket>;
 
-    auto connect(const endpoint& endpoint) -> ext::task<socket>;
+    auto connect_with_data(
+        const endpoint& endpoint,
+        std::span<const std::byte> data,
+        const connect_options& options = {}
+    ) -> ext::task<socket>;
 }
@@ -0,0 +1,291 @@
+#pragma once
+
+#include "deadline.hpp"
+#include "detail/awaiter.hpp"
+#include "runtime.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ext/coroutine>
+#include <ext/scope>
+#include <list>
+#include <optional>
+#include <timber/timber>
+#include <utility>
+
+namespace netcore {
+    struct connection_pool_options {
+        // Connections beyond this limit are not opened; checkouts wait for
+        // one to be returned instead. Zero means no limit.
+        std::size_t max_size = 0;
+        std::size_t min_idle = 0;
+        std::chrono::milliseconds health_check_interval =
+            std::chrono::seconds(5);
+        std::chrono::milliseconds idle_timeout = std::chrono::seconds(60);
+    };
+
+    struct connection_pool_metrics {
+        // Bucket 'i' counts waits shorter than 10^i microseconds; the last
+        // bucket counts everything longer.
+        static constexpr std::size_t wait_time_buckets = 8;
+
+        std::uint64_t checkouts = 0;
+        std::uint64_t connects = 0;
+        std::uint64_t evictions = 0;
+        std::uint64_t waits = 0;
+        std::array<std::uint64_t, wait_time_buckets> wait_time = {};
+
+        auto record_wait(std::chrono::nanoseconds duration) noexcept -> void {
+            using std::chrono::microseconds;
+
+            const auto micros =
+                std::chrono::duration_cast<microseconds>(duration).count();
+            std::size_t bucket = 0;
+
+            for (auto bound = 1LL;
+                 micros >= bound && bucket < wait_time_buckets - 1;
+                 bound *= 10) {
+                ++bucket;
+            }
+
+            ++waits;
+            ++wait_time[bucket];
+        }
+    };
+
+    namespace detail {
+        template <typename T>
+        struct task_result;
+
+        template <typename T>
+        struct task_result<ext::task<T>> {
+            using type = T;
+        };
+    }
+
+    template <typename Provider>
+    class connection_pool {
+    public:
+        using value_type = typename detail::task_result<
+            decltype(std::declval<Provider&>().provide())>::type;
+
+        class item {
+            friend class connection_pool;
+
+            connection_pool* pool = nullptr;
+            mutable std::optional<value_type> value;
+
+            item(connection_pool* pool, value_type&& value) :
+                pool(pool),
+                value(std::move(value)) {}
+        public:
+            item() = default;
+
+            item(const item&) = delete;
+
+            item(item&& other) :
+                pool(std::exchange(other.pool, nullptr)),
+                value(std::move(other.value)) {}
+
+            ~item() {
+                if (pool) pool->checkin(std::move(*value));
+            }
+
+            auto operator=(const item&) -> item& = delete;
+
+            auto operator=(item&& other) -> item& {
+                if (pool) pool->checkin(std::move(*value));
+
+                pool = std::exchange(other.pool, nullptr);
+                value = std::move(other.value);
+
+                return *this;
+            }
+
+            auto operator*() const noexcept -> value_type& { return *value; }
+
+            auto operator->() const noexcept -> value_type* {
+                return &*value;
+            }
+
+            // The connection is closed when the item is destroyed instead
+            // of being returned to the pool. It no longer counts against
+            // the pool, which need not outlive the item.
+            auto discard() -> void {
+                if (pool) std::exchange(pool, nullptr)->discard();
+            }
+        };
+    private:
+        using clock = std::chrono::steady_clock;
+
+        struct idle_connection {
+            value_type value;
+            clock::time_point since;
+        };
+
+        Provider provider;
+        connection_pool_options options;
+        connection_pool_metrics stats;
+        std::list<idle_connection> idle;
+        detail::awaiter_queue waiters;
+        deadline* maintenance = nullptr;
+        std::size_t open = 0;
+
+        auto check() -> void {
+            const auto now = clock::now();
+            auto it = idle.begin();
+
+            // Idle connections are ordered from least to most recently used,
+            // so the oldest are reaped first.
+            while (it != idle.end()) {
+                const auto expired = idle.size() > options.min_idle &&
+                                     now - it->since >= options.idle_timeout;
+
+                if (expired || !provider.checkout(it->value)) {
+                    it = idle.erase(it);
+                    evict();
+                }
+                else ++it;
+            }
+        }
+
+        auto checkin(value_type&& value) -> void {
+            if (provider.checkin(value)) {
+                idle.push_back({std::move(value), clock::now()});
+            }
+            else evict();
+
+            notify();
+        }
+
+        auto connect() -> ext::task<value_type> {
+            ++open;
+
+            try {
+                auto value = co_await provider.provide();
+                ++stats.connects;
+                co_return value;
+            }
+            catch (...) {
+                --open;
+                notify();
+                throw;
+            }
+        }
+
+        auto discard() -> void {
+            evict();
+            notify();
+        }
+
+        auto evict() noexcept -> void {
+            --open;
+            ++stats.evictions;
+        }
+
+        auto full() const noexcept -> bool {
+            return options.max_size != 0 && open >= options.max_size;
+        }
+
+        auto notify() -> void {
+            if (auto* next = waiters.pop()) runtime::current().enqueue(*next);
+        }
+    public:
+        connection_pool() = default;
+
+        template <typename... Args>
+        connection_pool(
+            const connection_pool_options& options,
+            Args&&... args
+        ) :
+            provider(std::forward<Args>(args)...),
+            options(options) {}
+
+        connection_pool(const connection_pool&) = delete;
+
+        connection_pool(connection_pool&&) = default;
+
+        auto operator=(const connection_pool&) -> connection_pool& = delete;
+
+        auto operator=(connection_pool&&) -> connection_pool& = default;
+
+        auto available() const noexcept -> std::size_t { return idle.size(); }
+
+        auto checkout() -> ext::task<item> {
+            ++stats.checkouts;
+
+            const auto start = clock::now();
+            auto waited = false;
+
+            while (true) {
+                while (!idle.empty()) {
+                    auto value = std::move(idle.back().value);
+                    idle.pop_back();
+
+                    // Without background health checks, connections are
+                    // verified as they are checked out.
+                    if (maintenance || provider.checkout(value)) {
+                        if (waited) stats.record_wait(clock::now() - start);
+                        co_return item(this, std::move(value));
+                    }
+
+                    evict();
+                }
+
+                if (!full()) {
+                    auto value = co_await connect();
+                    if (waited) stats.record_wait(clock::now() - start);
+                    co_return item(this, std::move(value));
+                }
+
+                waited = true;
+                co_await detail::awaitable(waiters, nullptr);
+            }
+        }
+
+        // Keeps the pool warm and checks idle connections in the background
+        // until stop() is called.
+        auto maintain() -> ext::jtask<> {
+            auto interval = deadline();
+            maintenance = &interval;
+
+            const auto deferred =
+                ext::scope_exit([this] { maintenance = nullptr; });
+
+            while (true) {
+                co_await warm();
+
+                interval.set(options.health_check_interval);
+                if (!co_await interval.wait()) break;
+
+                check();
+            }
+        }
+
+        auto metrics() const noexcept -> const connection_pool_metrics& {
+            return stats;
+        }
+
+        auto size() const noexcept -> std::size_t { return open; }
+
+        auto stop() -> void {
+            if (maintenance) maintenance->disarm();
+        }
+
+        auto warm() -> ext::task<> {
+            while (idle.size() < options.min_idle && !full()) {
+                try {
+                    auto value = co_await connect();
+                    idle.push_back({std::move(value), clock::now()});
+                }
+                catch (const std::exception& ex) {
+                    TIMBER_WARNING("Failed to warm connection: {}", ex.what());
+                    break;
+                }
+
+                notify();
+            }
+        }
+    };
+}
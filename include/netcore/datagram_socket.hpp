@@ -0,0 +1,76 @@
+#pragma once
+
+#include "address.hpp"
+#include "fd.hpp"
+#include "runtime.hpp"
+
+#include <cstdint>
+#include <ext/coroutine>
+#include <fmt/format.h>
+#include <memory>
+#include <span>
+#include <sys/socket.h>
+#include <vector>
+
+namespace netcore {
+    struct datagram {
+        std::span<const std::byte> data;
+        sockaddr_storage peer = {};
+        socklen_t peer_len = 0;
+        std::uint16_t segment_size = 0;
+        // Set on received datagrams that did not fit in 'max_size' bytes.
+        bool truncated = false;
+    };
+
+    struct datagram_options {
+        std::size_t batch_size = 32;
+        std::size_t max_size = 2048;
+    };
+
+    class datagram_socket {
+        netcore::fd descriptor;
+        std::shared_ptr<runtime::event> event;
+        datagram_options options;
+        bool gro = false;
+        std::unique_ptr<std::byte[]> storage;
+        std::unique_ptr<char[]> control;
+        std::vector<datagram> received;
+        std::vector<iovec> iov;
+        std::vector<mmsghdr> headers;
+    public:
+        datagram_socket() = default;
+
+        datagram_socket(int domain, const datagram_options& options = {});
+
+        auto bind(const netcore::address& address) -> void;
+
+        auto cancel() noexcept -> void;
+
+        auto connect(const sockaddr* addr, socklen_t len) -> void;
+
+        // Coalesced datagrams can approach 64 KiB, so the receive buffers
+        // are enlarged to that size if they are smaller.
+        auto enable_gro() -> bool;
+
+        auto fd() const noexcept -> int;
+
+        auto receive() -> ext::task<std::span<const datagram>>;
+
+        auto send(std::span<const datagram> datagrams) -> ext::task<>;
+
+        auto valid() const -> bool;
+    };
+}
+
+template <>
+struct fmt::formatter<netcore::datagram_socket> {
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext& ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(const netcore::datagram_socket& socket, FormatContext& ctx) {
+        return fmt::format_to(ctx.out(), "datagram socket ({})", socket.fd());
+    }
+};
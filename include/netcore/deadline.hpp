@@ -0,0 +1,64 @@
+#pragma once
+
+#include "runtime.hpp"
+
+#include <chrono>
+#include <coroutine>
+
+namespace netcore {
+    // A timer kept by the runtime rather than the kernel: setting and
+    // disarming it makes no system calls. Expiry is detected with
+    // millisecond resolution.
+    class deadline {
+        friend class runtime;
+
+        runtime* owner = nullptr;
+        runtime::deadline_map::iterator entry;
+        detail::awaiter awaiter;
+        bool scheduled = false;
+        bool expired = false;
+        bool woken = false;
+        bool suspended = false;
+
+        auto expire() -> void;
+
+        auto unschedule() noexcept -> void;
+
+        auto wake() -> void;
+    public:
+        class awaitable {
+            deadline& d;
+        public:
+            explicit awaitable(deadline& d) noexcept;
+
+            auto await_ready() const noexcept -> bool;
+
+            auto await_suspend(std::coroutine_handle<> coroutine) -> void;
+
+            auto await_resume() noexcept -> bool;
+        };
+
+        deadline() = default;
+
+        deadline(const deadline&) = delete;
+
+        deadline(deadline&&) = delete;
+
+        ~deadline();
+
+        auto operator=(const deadline&) -> deadline& = delete;
+
+        auto operator=(deadline&&) -> deadline& = delete;
+
+        // Wakes the current waiter or, if there is none, the next one.
+        auto disarm() -> void;
+
+        auto set(std::chrono::nanoseconds duration) -> void;
+
+        // Returns true if the deadline expired, or false if it was disarmed.
+        [[nodiscard]]
+        auto wait() noexcept -> awaitable;
+
+        auto waiting() const noexcept -> bool;
+    };
+}
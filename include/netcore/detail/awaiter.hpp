@@ -59,6 +59,8 @@ namespace netcore::detail {
 
         auto pop() noexcept -> awaiter*;
 
+        auto remove(awaiter& a) noexcept -> void;
+
         auto resume() -> void;
 
         auto size() -> std::size_t;
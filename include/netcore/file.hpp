@@ -1,9 +1,60 @@
 #pragma once
 
+#include "awaitable_thread_pool.hpp"
 #include "fd.hpp"
 
+#include <fcntl.h>
 #include <filesystem>
 
 namespace netcore {
-    auto open(const std::filesystem::path& path, int flags) -> fd;
+    struct file_options {
+        int advice = POSIX_FADV_SEQUENTIAL;
+        std::size_t read_ahead = 512 * 1024;
+    };
+
+    class file {
+        netcore::fd descriptor;
+        awaitable_thread_pool* pool = nullptr;
+        file_options options;
+        off_t position = 0;
+        off_t advised = 0;
+
+        auto advance(long bytes) noexcept -> long;
+    public:
+        file() = default;
+
+        file(
+            awaitable_thread_pool& pool,
+            netcore::fd&& descriptor,
+            const file_options& options = {}
+        );
+
+        file(
+            awaitable_thread_pool& pool,
+            const std::filesystem::path& path,
+            int flags,
+            const file_options& options = {}
+        );
+
+        auto await_write() -> ext::task<>;
+
+        auto fd() const noexcept -> int;
+
+        auto read(void* dest, std::size_t len) -> ext::task<std::size_t>;
+
+        auto seek(off_t offset) noexcept -> void;
+
+        auto tell() const noexcept -> off_t;
+
+        auto try_read(void* dest, std::size_t len) -> long;
+
+        auto try_write(const void* src, std::size_t len) -> long;
+
+        auto valid() const -> bool;
+
+        auto write(const void* src, std::size_t len) -> ext::task<std::size_t>;
+    };
+
+    auto open(const std::filesystem::path& path, int flags, mode_t mode = 0666)
+        -> fd;
 }
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "fd.hpp"
+
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unordered_map>
+
+namespace netcore {
+    class file_cache {
+    public:
+        struct entry {
+            netcore::fd descriptor;
+            struct stat status;
+        };
+    private:
+        using item = std::pair<std::string, std::shared_ptr<const entry>>;
+        using list = std::list<item>;
+
+        std::size_t max_size;
+        list entries;
+        std::unordered_map<std::string, list::iterator> index;
+
+        auto erase(list::iterator it) -> void;
+    public:
+        static auto current() -> file_cache&;
+
+        explicit file_cache(std::size_t max_size = 64);
+
+        auto clear() noexcept -> void;
+
+        auto open(const std::filesystem::path& path)
+            -> std::shared_ptr<const entry>;
+
+        auto size() const noexcept -> std::size_t;
+    };
+}
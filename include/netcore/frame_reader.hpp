@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <ext/coroutine>
+#include <fmt/format.h>
+#include <memory>
+#include <span>
+#include <stdexcept>
+
+namespace netcore {
+    struct frame_options {
+        std::size_t prefix_size = sizeof(std::uint32_t);
+        std::endian byte_order = std::endian::big;
+        std::size_t max_size = 16 * 1024 * 1024;
+    };
+
+    template <typename Reader>
+    requires requires(Reader& reader, void* dest, std::size_t len) {
+        { reader.capacity() } -> std::convertible_to<std::size_t>;
+        { reader.consume(len) };
+        {
+            reader.peek(len)
+        } -> std::same_as<ext::task<std::span<const std::byte>>>;
+        { reader.read(dest, len) } -> std::same_as<ext::task<>>;
+    }
+    class frame_reader final {
+        Reader* reader;
+        frame_options options;
+        std::unique_ptr<std::byte[]> storage;
+        std::size_t storage_size = 0;
+
+        auto decode(std::span<const std::byte> prefix) const noexcept
+            -> std::size_t {
+            std::size_t result = 0;
+
+            if (options.byte_order == std::endian::big) {
+                for (const auto byte : prefix) {
+                    result = (result << 8) | std::to_integer<std::size_t>(byte);
+                }
+            }
+            else {
+                for (auto it = prefix.rbegin(); it != prefix.rend(); ++it) {
+                    result = (result << 8) | std::to_integer<std::size_t>(*it);
+                }
+            }
+
+            return result;
+        }
+
+        auto reserve(std::size_t len) -> std::byte* {
+            if (len > storage_size) {
+                storage_size = std::max(len, storage_size * 2);
+                storage = std::make_unique_for_overwrite<std::byte[]>(
+                    storage_size
+                );
+            }
+
+            return storage.get();
+        }
+    public:
+        frame_reader(Reader& reader, const frame_options& options = {}) :
+            reader(&reader),
+            options(options) {
+            if (options.prefix_size == 0 ||
+                options.prefix_size > sizeof(std::size_t)) {
+                throw std::invalid_argument(fmt::format(
+                    "unsupported frame prefix size: {}",
+                    options.prefix_size
+                ));
+            }
+        }
+
+        // The returned view points into the reader's buffer when the frame
+        // fits, and into storage owned by this object otherwise. Either way,
+        // it is only valid until the next read.
+        auto read() -> ext::task<std::span<const std::byte>> {
+            const auto len =
+                decode(co_await reader->peek(options.prefix_size));
+
+            if (len > options.max_size) {
+                throw std::runtime_error(fmt::format(
+                    "frame size ({:L} bytes) exceeds maximum ({:L} bytes)",
+                    len,
+                    options.max_size
+                ));
+            }
+
+            reader->consume(options.prefix_size);
+
+            if (len <= reader->capacity()) {
+                const auto frame = co_await reader->peek(len);
+                reader->consume(len);
+                co_return frame;
+            }
+
+            auto* const dest = reserve(len);
+            co_await reader->read(dest, len);
+
+            co_return std::span<const std::byte>(dest, len);
+        }
+
+        auto read_from(Reader& reader) noexcept -> void {
+            this->reader = &reader;
+        }
+    };
+}
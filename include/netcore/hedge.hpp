@@ -0,0 +1,230 @@
+#pragma once
+
+#include "connection_pool.hpp"
+#include "deadline.hpp"
+#include "event.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <timber/timber>
+#include <type_traits>
+#include <vector>
+
+namespace netcore {
+    struct hedge_options {
+        // A backup request is sent once the primary has taken longer than
+        // this percentile of recent request latencies.
+        double percentile = 0.95;
+        // Used until enough latencies have been sampled.
+        std::chrono::milliseconds initial_delay = std::chrono::milliseconds(10);
+        std::chrono::milliseconds min_delay = std::chrono::milliseconds(1);
+        std::size_t min_samples = 20;
+        std::size_t window = 1024;
+        // Backup requests allowed per request. Unused budget accumulates up
+        // to 'burst' backup requests.
+        double budget = 0.1;
+        double burst = 10;
+    };
+
+    struct hedge_metrics {
+        std::uint64_t requests = 0;
+        std::uint64_t hedges = 0;
+        // Backup requests that answered before the primary.
+        std::uint64_t wins = 0;
+        // Backup requests not sent because the budget was exhausted.
+        std::uint64_t throttled = 0;
+    };
+
+    template <typename Client>
+    requires requires(typename Client::value_type& t) { t.cancel(); }
+    class hedger {
+        using clock = std::chrono::steady_clock;
+        using item_type = typename detail::task_result<
+            decltype(std::declval<Client&>().connect())>::type;
+        using value_type = typename Client::value_type;
+
+        template <typename F>
+        using result_type = typename detail::task_result<
+            std::invoke_result_t<F&, value_type&>>::type;
+
+        static constexpr std::size_t update_interval = 16;
+
+        // Shared with every attempt, so that an abandoned attempt can
+        // finish after the request has returned.
+        template <typename F>
+        struct race {
+            F f;
+            std::optional<result_type<F>> result;
+            std::exception_ptr error;
+            std::array<item_type*, 2> running = {};
+            netcore::event<> done;
+            netcore::deadline timer;
+            bool delaying = false;
+            std::size_t winner = 0;
+
+            race(F&& f) : f(std::move(f)) {}
+
+            auto pending() const noexcept -> bool {
+                return std::any_of(
+                    running.begin(),
+                    running.end(),
+                    [](const item_type* item) { return item != nullptr; }
+                );
+            }
+        };
+
+        Client* client;
+        hedge_options options;
+        hedge_metrics stats;
+        std::vector<std::chrono::nanoseconds> samples;
+        std::vector<std::chrono::nanoseconds> scratch;
+        std::size_t next_sample = 0;
+        std::size_t stale = 0;
+        std::chrono::nanoseconds current_delay;
+        double credit = 0;
+
+        auto allow() noexcept -> bool {
+            if (credit < 1) {
+                ++stats.throttled;
+                return false;
+            }
+
+            credit -= 1;
+            ++stats.hedges;
+            return true;
+        }
+
+        template <typename F>
+        static auto run(
+            std::shared_ptr<race<F>> state,
+            std::size_t index,
+            item_type item
+        ) -> ext::detached_task {
+            state->running[index] = &item;
+
+            try {
+                auto response = co_await state->f(*item);
+
+                if (!state->result) {
+                    state->result = std::move(response);
+                    state->winner = index;
+                }
+            }
+            catch (...) {
+                if (!state->error) state->error = std::current_exception();
+            }
+
+            state->running[index] = nullptr;
+
+            if (state->delaying) state->timer.disarm();
+            state->done.emit();
+        }
+
+        auto record(std::chrono::nanoseconds latency) -> void {
+            if (samples.size() < options.window) samples.push_back(latency);
+            else {
+                samples[next_sample] = latency;
+                next_sample = (next_sample + 1) % options.window;
+            }
+
+            if (samples.size() < options.min_samples) return;
+            if (++stale < update_interval && current_delay.count() != 0) {
+                return;
+            }
+
+            stale = 0;
+            scratch.assign(samples.begin(), samples.end());
+
+            const auto rank = static_cast<std::ptrdiff_t>(
+                options.percentile * static_cast<double>(scratch.size() - 1)
+            );
+            const auto nth = scratch.begin() + rank;
+
+            std::nth_element(scratch.begin(), nth, scratch.end());
+            current_delay = std::max<std::chrono::nanoseconds>(
+                *nth,
+                options.min_delay
+            );
+        }
+    public:
+        hedger(Client& client, const hedge_options& options = {}) :
+            client(&client),
+            options(options),
+            current_delay(0) {
+            samples.reserve(options.window);
+        }
+
+        auto delay() const noexcept -> std::chrono::nanoseconds {
+            if (current_delay.count() == 0) return options.initial_delay;
+            return current_delay;
+        }
+
+        auto metrics() const noexcept -> const hedge_metrics& { return stats; }
+
+        // Calls 'f' with a connection from the client. If it has not
+        // completed within the hedging delay, 'f' is called again with a
+        // second connection and the first response wins. The losing
+        // attempt is cancelled and left to finish on its own; its
+        // connection is closed rather than returned to the pool, since its
+        // stream may contain a partial exchange.
+        template <typename F>
+        auto request(F f) -> ext::task<result_type<F>> {
+            ++stats.requests;
+            credit = std::min(credit + options.budget, options.burst);
+
+            const auto start = clock::now();
+            const auto state = std::make_shared<race<F>>(std::move(f));
+
+            auto primary = co_await client->connect();
+            run(state, 0, std::move(primary));
+
+            if (state->running[0]) {
+                auto& timer = state->timer;
+                timer.set(std::max(delay(), std::chrono::nanoseconds(1)));
+
+                state->delaying = true;
+                const auto expired = co_await timer.wait();
+                state->delaying = false;
+
+                if (expired && state->running[0] && allow()) {
+                    try {
+                        auto backup = co_await client->connect();
+                        run(state, 1, std::move(backup));
+                    }
+                    catch (const std::exception& ex) {
+                        TIMBER_DEBUG(
+                            "Failed to send hedged request: {}",
+                            ex.what()
+                        );
+                    }
+                }
+            }
+
+            while (!state->result && state->pending()) {
+                co_await state->done.listen();
+            }
+
+            // The loser is not awaited: it may be busy with something other
+            // than its socket. Its connection leaves the pool first, as
+            // cancelling it can complete the attempt immediately.
+            for (auto* item : state->running) {
+                if (!item) continue;
+
+                item->discard();
+                (*item)->cancel();
+            }
+
+            if (!state->result) std::rethrow_exception(state->error);
+
+            if (state->winner != 0) ++stats.wins;
+            record(clock::now() - start);
+
+            co_return std::move(*state->result);
+        }
+    };
+}
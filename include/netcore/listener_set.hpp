@@ -0,0 +1,54 @@
+#pragma once
+
+#include "endpoint.hpp"
+#include "fd.hpp"
+#include "socket.h"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace netcore {
+    // Listening sockets opened by another process. Servers take the socket
+    // matching their endpoint instead of binding a new one, so connections
+    // waiting in the kernel's backlog are not refused. Descriptors are
+    // returned as is, to be adopted by a server_socket on the thread that
+    // serves them.
+    class listener_set {
+        struct listener {
+            netcore::fd descriptor;
+            std::string name;
+        };
+
+        std::vector<listener> listeners;
+    public:
+        // Tells the process that offered the sockets that they are being
+        // served, after which it stops accepting connections.
+        static auto acknowledge(socket& control) -> ext::task<>;
+
+        // Sockets passed by systemd socket activation (LISTEN_FDS), named
+        // after LISTEN_FDNAMES. The variables are unset so that child
+        // processes do not inherit them.
+        static auto from_environment() -> listener_set;
+
+        // Sends listening sockets to another process and waits for it to
+        // report that it is accepting connections on them. Returns false if
+        // the other process disconnects first.
+        static auto offer(socket& control, std::span<const int> fds)
+            -> ext::task<bool>;
+
+        static auto receive(socket& control) -> ext::task<listener_set>;
+
+        auto add(int fd, std::string_view name = {}) -> void;
+
+        auto empty() const noexcept -> bool;
+
+        auto size() const noexcept -> std::size_t;
+
+        // Returns an invalid descriptor if no socket matches.
+        auto take(const endpoint& endpoint) -> netcore::fd;
+
+        auto take(std::string_view name) -> netcore::fd;
+    };
+}
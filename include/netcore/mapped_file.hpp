@@ -0,0 +1,75 @@
+#pragma once
+
+#include "except.hpp"
+#include "fd.hpp"
+
+#include <ext/coroutine>
+#include <filesystem>
+#include <span>
+#include <sys/mman.h>
+
+namespace netcore {
+    struct mapped_file_options {
+        int advice = MADV_SEQUENTIAL;
+        bool populate = false;
+    };
+
+    class mapped_file {
+        std::byte* address = nullptr;
+        std::size_t length = 0;
+        std::size_t position = 0;
+
+        auto remaining() const noexcept -> std::span<const std::byte>;
+    public:
+        mapped_file() = default;
+
+        mapped_file(
+            const netcore::fd& descriptor,
+            const mapped_file_options& options = {}
+        );
+
+        mapped_file(
+            const std::filesystem::path& path,
+            const mapped_file_options& options = {}
+        );
+
+        mapped_file(const mapped_file&) = delete;
+
+        mapped_file(mapped_file&& other) noexcept;
+
+        ~mapped_file();
+
+        auto operator=(const mapped_file&) -> mapped_file& = delete;
+
+        auto operator=(mapped_file&& other) noexcept -> mapped_file&;
+
+        auto advise(std::size_t offset, std::size_t len, int advice) const
+            -> void;
+
+        auto capacity() const noexcept -> std::size_t;
+
+        auto consume(std::size_t len) noexcept -> void;
+
+        auto data() const noexcept -> std::span<const std::byte>;
+
+        auto done() const noexcept -> bool;
+
+        auto peek() -> ext::task<std::span<const std::byte>>;
+
+        auto peek(std::size_t len) -> ext::task<std::span<const std::byte>>;
+
+        auto read() -> ext::task<std::span<const std::byte>>;
+
+        auto read(std::size_t len) -> ext::task<std::span<const std::byte>>;
+
+        auto read(void* dest, std::size_t len) -> ext::task<>;
+
+        auto seek(std::size_t offset) noexcept -> void;
+
+        auto size() const noexcept -> std::size_t;
+
+        auto tell() const noexcept -> std::size_t;
+
+        auto try_read(void* dest, std::size_t len) noexcept -> long;
+    };
+}
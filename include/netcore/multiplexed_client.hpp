@@ -0,0 +1,361 @@
+#pragma once
+
+#include "buffered_socket.hpp"
+#include "detail/awaiter.hpp"
+#include "mutex.hpp"
+#include "runtime.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <ext/scope>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace netcore {
+    // Responses arrive in the order their requests were written.
+    template <typename T>
+    concept pipeline_codec = requires(
+        T& codec,
+        buffered_socket& socket,
+        const typename T::request_type& request
+    ) {
+        {
+            codec.read(socket)
+        } -> std::same_as<ext::task<typename T::response_type>>;
+
+        { codec.write(socket, request) } -> std::same_as<ext::task<>>;
+    };
+
+    // Responses carry the ID of the request they answer and may arrive in
+    // any order.
+    template <typename T>
+    concept multiplex_codec = requires(
+        T& codec,
+        buffered_socket& socket,
+        std::uint64_t id,
+        const typename T::request_type& request
+    ) {
+        {
+            codec.read(socket)
+        } -> std::same_as<ext::task<
+            std::pair<std::uint64_t, typename T::response_type>>>;
+
+        { codec.write(socket, id, request) } -> std::same_as<ext::task<>>;
+    };
+
+    template <typename T>
+    concept request_codec = pipeline_codec<T> || multiplex_codec<T>;
+
+    template <request_codec Codec>
+    class multiplexed_connection final {
+    public:
+        using request_type = typename Codec::request_type;
+        using response_type = typename Codec::response_type;
+    private:
+        static constexpr auto multiplexed = multiplex_codec<Codec>;
+
+        struct pending {
+            std::optional<response_type> response;
+            detail::awaiter awaiter;
+            bool done = false;
+        };
+
+        class awaitable {
+            pending& p;
+        public:
+            awaitable(pending& p) : p(p) {}
+
+            auto await_ready() const noexcept -> bool { return p.done; }
+
+            auto await_suspend(std::coroutine_handle<> coroutine) -> void {
+                p.awaiter.coroutine = coroutine;
+            }
+
+            auto await_resume() -> response_type {
+                if (p.awaiter.exception) {
+                    std::rethrow_exception(p.awaiter.exception);
+                }
+
+                return std::move(*p.response);
+            }
+        };
+
+        using outstanding_type = std::conditional_t<
+            multiplexed,
+            std::unordered_map<std::uint64_t, pending*>,
+            std::deque<pending*>>;
+
+        Codec* codec;
+        mutex<buffered_socket> socket;
+        outstanding_type outstanding;
+        ext::jtask<> reader;
+        std::uint64_t next_id = 0;
+        std::size_t writers = 0;
+        bool error = false;
+        bool reading = false;
+        bool unflushed = false;
+
+        auto complete(pending& p) -> void {
+            p.done = true;
+            if (p.awaiter.coroutine) runtime::current().enqueue(p.awaiter);
+        }
+
+        auto fail(std::exception_ptr exception) -> void {
+            error = true;
+
+            for (auto& entry : outstanding) {
+                pending* p = nullptr;
+
+                if constexpr (multiplexed) p = entry.second;
+                else p = entry;
+
+                p->awaiter.exception = exception;
+                complete(*p);
+            }
+
+            outstanding.clear();
+        }
+
+        auto next() -> ext::task<> {
+            if constexpr (multiplexed) {
+                auto [id, response] = co_await codec->read(socket.get());
+                const auto it = outstanding.find(id);
+
+                if (it == outstanding.end()) {
+                    throw std::runtime_error(fmt::format(
+                        "received a response for an unknown request ({})",
+                        id
+                    ));
+                }
+
+                auto* const p = it->second;
+                outstanding.erase(it);
+
+                p->response = std::move(response);
+                complete(*p);
+            }
+            else {
+                auto response = co_await codec->read(socket.get());
+                auto* const p = outstanding.front();
+                outstanding.pop_front();
+
+                p->response = std::move(response);
+                complete(*p);
+            }
+        }
+
+        // A single reader runs while requests are outstanding and hands each
+        // response to the request that is waiting for it. It reads without
+        // the lock: the buffered socket keeps separate read and write
+        // buffers, writers only touch the write side, and everything runs
+        // on one thread.
+        auto read_responses() -> ext::jtask<> {
+            reading = true;
+            const auto deferred = ext::scope_exit([this] { reading = false; });
+
+            try {
+                while (!outstanding.empty()) co_await next();
+            }
+            catch (...) {
+                fail(std::current_exception());
+            }
+        }
+
+        auto remove(pending& p) noexcept -> void {
+            if constexpr (multiplexed) {
+                std::erase_if(outstanding, [&p](const auto& entry) {
+                    return entry.second == &p;
+                });
+            }
+            else std::erase(outstanding, &p);
+        }
+    public:
+        multiplexed_connection(Codec& codec, buffered_socket&& socket) :
+            codec(&codec),
+            socket(std::move(socket)) {}
+
+        multiplexed_connection(const multiplexed_connection&) = delete;
+
+        multiplexed_connection(multiplexed_connection&&) = delete;
+
+        auto operator=(const multiplexed_connection&)
+            -> multiplexed_connection& = delete;
+
+        auto operator=(multiplexed_connection&&)
+            -> multiplexed_connection& = delete;
+
+        auto failed() const noexcept -> bool { return error; }
+
+        auto idle() const noexcept -> bool {
+            return outstanding.empty() && writers == 0 && !reading;
+        }
+
+        auto pending_requests() const noexcept -> std::size_t {
+            return outstanding.size() + writers;
+        }
+
+        auto request(const request_type& request) -> ext::task<response_type> {
+            auto p = pending();
+
+            {
+                ++writers;
+                const auto deferred = ext::scope_exit([this] { --writers; });
+
+                auto guard = co_await socket.lock();
+
+                if (error) {
+                    throw std::runtime_error("multiplexed connection failed");
+                }
+
+                auto id = std::uint64_t();
+
+                if constexpr (multiplexed) {
+                    id = next_id++;
+                    outstanding.emplace(id, &p);
+                }
+                else outstanding.push_back(&p);
+
+                if (!reading) reader = read_responses();
+
+                try {
+                    if constexpr (multiplexed) {
+                        co_await codec->write(*guard, id, request);
+                    }
+                    else co_await codec->write(*guard, request);
+
+                    unflushed = true;
+
+                    // Requests are left in the buffer for a writer waiting
+                    // for the lock, which flushes them together with its
+                    // own. The last writer in line flushes for everyone.
+                    if (unflushed && !socket.contended()) {
+                        unflushed = false;
+                        co_await guard->flush();
+                    }
+                }
+                catch (...) {
+                    // A partially written request leaves the stream in an
+                    // unknown state, so the connection cannot be reused.
+                    remove(p);
+                    error = true;
+                    unflushed = false;
+                    guard->cancel();
+                    throw;
+                }
+            }
+
+            co_return co_await awaitable(p);
+        }
+    };
+
+    struct multiplex_options {
+        std::size_t connections = 1;
+        std::size_t buffer_size = 8192;
+        connect_options connect;
+    };
+
+    template <request_codec Codec>
+    class multiplexed_client final {
+        using connection = multiplexed_connection<Codec>;
+
+        netcore::endpoint endpoint;
+        Codec codec;
+        multiplex_options options;
+        std::vector<std::unique_ptr<connection>> connections;
+        detail::awaiter_queue waiters;
+        std::size_t connecting = 0;
+
+        auto open() -> ext::task<connection*> {
+            ++connecting;
+
+            const auto deferred = ext::scope_exit([this] {
+                --connecting;
+
+                while (auto* a = waiters.pop()) {
+                    runtime::current().enqueue(*a);
+                }
+            });
+
+            auto socket = co_await buffered_socket::connect(
+                endpoint,
+                options.buffer_size,
+                options.connect
+            );
+
+            co_return connections
+                .emplace_back(
+                    std::make_unique<connection>(codec, std::move(socket))
+                )
+                .get();
+        }
+
+        auto select() -> ext::task<connection*> {
+            while (true) {
+                std::erase_if(connections, [](const auto& c) {
+                    return c->failed() && c->idle();
+                });
+
+                connection* selected = nullptr;
+
+                for (const auto& c : connections) {
+                    if (c->failed()) continue;
+
+                    if (!selected ||
+                        c->pending_requests() < selected->pending_requests()) {
+                        selected = c.get();
+                    }
+                }
+
+                const auto room =
+                    connections.size() + connecting < options.connections;
+                const auto busy = !selected || selected->pending_requests() > 0;
+
+                // Failed connections that still have requests in flight
+                // count against the limit, but are not waited for.
+                if ((room && busy) || (!selected && connecting == 0)) {
+                    co_return co_await open();
+                }
+
+                if (selected) co_return selected;
+
+                co_await detail::awaitable(waiters, nullptr);
+            }
+        }
+    public:
+        using request_type = typename Codec::request_type;
+        using response_type = typename Codec::response_type;
+
+        multiplexed_client(
+            std::string_view endpoint,
+            Codec codec = {},
+            const multiplex_options& options = {}
+        ) :
+            endpoint(parse_endpoint(endpoint)),
+            codec(std::move(codec)),
+            options(options) {}
+
+        multiplexed_client(const multiplexed_client&) = delete;
+
+        multiplexed_client(multiplexed_client&&) = delete;
+
+        auto operator=(const multiplexed_client&)
+            -> multiplexed_client& = delete;
+
+        auto operator=(multiplexed_client&&) -> multiplexed_client& = delete;
+
+        auto request(const request_type& request) -> ext::task<response_type> {
+            auto* const c = co_await select();
+            co_return co_await c->request(request);
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return connections.size();
+        }
+    };
+}
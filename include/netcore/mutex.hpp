@@ -9,6 +9,38 @@
 namespace netcore {
     template <typename T>
     class mutex {
+        // Leaves the queue if destroyed while waiting, so that the lock is
+        // never handed to a cancelled coroutine.
+        class awaitable {
+            mutex& m;
+            detail::awaiter a;
+            bool waiting = false;
+        public:
+            explicit awaitable(mutex& m) noexcept : m(m) {}
+
+            awaitable(const awaitable&) = delete;
+
+            awaitable(awaitable&&) = delete;
+
+            ~awaitable() {
+                if (waiting) m.awaiters.remove(a);
+            }
+
+            auto operator=(const awaitable&) -> awaitable& = delete;
+
+            auto operator=(awaitable&&) -> awaitable& = delete;
+
+            auto await_ready() const noexcept -> bool { return false; }
+
+            auto await_suspend(std::coroutine_handle<> coroutine) -> void {
+                a.coroutine = coroutine;
+                m.awaiters.enqueue(a);
+                waiting = true;
+            }
+
+            auto await_resume() noexcept -> void { waiting = false; }
+        };
+
         detail::awaiter_queue awaiters;
         T data;
         bool locked = false;
@@ -62,10 +94,13 @@ namespace netcore {
 
         auto operator=(mutex&&) -> mutex& = delete;
 
+        // Returns true if any coroutine is waiting for the lock.
+        auto contended() const noexcept -> bool { return !awaiters.empty(); }
+
         auto get() noexcept -> T& { return data; }
 
         auto lock() -> ext::task<guard> {
-            if (locked) co_await detail::awaitable(awaiters, nullptr);
+            if (locked) co_await awaitable(*this);
 
             locked = true;
             co_return guard(this);
@@ -19,6 +19,10 @@ namespace netcore {
 
         auto read() -> fd;
 
+        auto reader() const noexcept -> int;
+
         auto write() -> fd;
+
+        auto writer() const noexcept -> int;
     };
 }
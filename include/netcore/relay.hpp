@@ -0,0 +1,15 @@
+#pragma once
+
+#include "socket.h"
+
+namespace netcore {
+    struct relay_counters {
+        std::size_t a_to_b = 0;
+        std::size_t b_to_a = 0;
+    };
+
+    auto relay(socket& a, socket& b, relay_counters& counters) -> ext::task<>;
+
+    auto splice_to(socket& source, socket& dest, std::size_t& counter)
+        -> ext::task<>;
+}
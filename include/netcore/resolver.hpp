@@ -0,0 +1,57 @@
+#pragma once
+
+#include "address.hpp"
+#include "awaitable_thread_pool.hpp"
+#include "detail/awaiter.hpp"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace netcore {
+    struct resolver_options {
+        std::chrono::seconds ttl = std::chrono::seconds(60);
+        std::chrono::seconds negative_ttl = std::chrono::seconds(5);
+        std::size_t max_entries = 1024;
+    };
+
+    class resolver {
+        using clock = std::chrono::steady_clock;
+
+        struct entry {
+            std::shared_ptr<const address> result;
+            std::exception_ptr error;
+            clock::time_point expires;
+        };
+
+        std::unique_ptr<awaitable_thread_pool> owned;
+        awaitable_thread_pool* pool;
+        resolver_options options;
+        std::unordered_map<std::string, entry> cache;
+        std::unordered_map<std::string, detail::awaiter_queue> lookups;
+
+        auto store(std::string&& key, entry&& value) -> void;
+    public:
+        // The resolver used when none is given. Each runtime has its own,
+        // which resolves names on threads of its own.
+        static auto current() -> resolver&;
+
+        explicit resolver(const resolver_options& options = {});
+
+        resolver(
+            awaitable_thread_pool& pool,
+            const resolver_options& options = {}
+        );
+
+        auto clear() noexcept -> void;
+
+        auto resolve(
+            std::string_view host,
+            std::string_view port,
+            int type = SOCK_STREAM
+        ) -> ext::task<std::shared_ptr<const address>>;
+
+        auto size() const noexcept -> std::size_t;
+    };
+}
@@ -6,25 +6,43 @@
 #include <chrono>
 #include <ext/coroutine>
 #include <ext/except.h>
+#include <map>
 #include <memory>
 #include <sys/epoll.h>
 #include <sys/socket.h>
 #include <timber/timber>
 
 namespace netcore {
+    class deadline;
+    class resolver;
+
     class runtime {
+        friend class deadline;
+        friend class resolver;
+
+        using deadline_map =
+            std::multimap<std::chrono::steady_clock::time_point, deadline*>;
+
         const std::unique_ptr<epoll_event[]> events;
         const int max_events;
 
         detail::awaiter_queue pending;
         unsigned long awaiters = 0;
+        deadline_map deadlines;
+        std::unique_ptr<resolver> default_resolver;
     public:
         class event : public std::enable_shared_from_this<event> {
+            friend class runtime;
+
             int descriptor;
             std::uint32_t received;
             bool canceled = false;
+            event* next_retired = nullptr;
+            bool retired = false;
 
             event(int fd, std::uint32_t events) noexcept;
+
+            static auto destroy(event* e) noexcept -> void;
         public:
             class awaitable {
                 runtime::event& event;
@@ -73,7 +91,19 @@ namespace netcore {
 
             auto resume(std::uint32_t events) -> void;
         };
+    private:
+        // Events destroyed while a batch of ready events is being processed
+        // are freed only once the batch is done, since the batch may still
+        // refer to them.
+        event* retired = nullptr;
+        bool dispatching = false;
+
+        auto expire() -> void;
 
+        auto release() noexcept -> void;
+
+        auto timeout() const -> int;
+    public:
         friend class event::awaitable;
 
         static auto active() -> bool;
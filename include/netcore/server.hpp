@@ -3,6 +3,7 @@
 #include "server_socket.hpp"
 
 #include <netcore/address.hpp>
+#include <netcore/deadline.hpp>
 #include <netcore/endpoint.hpp>
 #include <netcore/event.hpp>
 #include <netcore/except.hpp>
@@ -12,16 +13,28 @@
 #include <ext/scope>
 #include <fcntl.h>
 #include <filesystem>
+#include <list>
+#include <stdexcept>
 #include <sys/un.h>
 #include <timber/timber>
+#include <vector>
 
 namespace netcore {
     template <typename T>
-    concept server_context = requires(T& t, socket&& client) {
-        {
-            t.connection(std::forward<socket>(client))
-        } -> std::same_as<ext::task<>>;
-    };
+    concept server_context_peer =
+        requires(T& t, socket&& client, const peer_address& peer) {
+            {
+                t.connection(std::forward<socket>(client), peer)
+            } -> std::same_as<ext::task<>>;
+        };
+
+    template <typename T>
+    concept server_context = server_context_peer<T> ||
+                             requires(T& t, socket&& client) {
+                                 {
+                                     t.connection(std::forward<socket>(client))
+                                 } -> std::same_as<ext::task<>>;
+                             };
 
     template <typename T>
     concept server_context_backlog = requires(T t) {
@@ -38,6 +51,11 @@ namespace netcore {
         { t.listen(addr) } -> std::same_as<void>;
     };
 
+    template <typename T>
+    concept server_context_options = requires(T t) {
+        { t.options } -> std::convertible_to<socket_options>;
+    };
+
     template <typename T>
     concept server_context_shutdown = requires(T t) {
         { t.shutdown() } -> std::same_as<void>;
@@ -46,21 +64,60 @@ namespace netcore {
     template <server_context T>
     class server final {
         ext::counter connection_counter;
+        std::list<std::weak_ptr<runtime::event>> clients;
+        deadline* draining = nullptr;
         server_socket* socket = nullptr;
         address_type addr;
+        socket_options accepted_options;
+        bool handed_off = false;
+
+        // Options such as SO_REUSEPORT only take effect before the socket is
+        // bound. Accepted sockets inherit most options from the listener,
+        // so only the remainder needs to be applied to each client.
+        auto configure(server_socket& socket) -> void {
+            if constexpr (server_context_options<T>) {
+                const auto options = socket_options(context.options);
+
+                socket.configure(options);
+                accepted_options = options.accepted();
+            }
+        }
+
+        auto finish() -> ext::task<> {
+            if constexpr (server_context_shutdown<T>) context.shutdown();
+
+            if (connection_counter) co_await connection_counter.await();
+            else co_await yield();
 
-        auto handle_connection(netcore::socket&& client) -> ext::detached_task {
+            if constexpr (server_context_close<T>) context.close();
+        }
+
+        auto handle_connection(
+            netcore::socket&& client,
+            peer_address peer
+        ) -> ext::detached_task {
             const auto fd = client.fd();
             const auto counter_guard = connection_counter.increment();
 
+            const auto entry =
+                clients.insert(clients.end(), client.cancellation());
+            const auto registered = ext::scope_exit([this, entry] {
+                clients.erase(entry);
+                if (clients.empty() && draining) draining->disarm();
+            });
+
             TIMBER_DEBUG(
-                "Client ({}) connected: {:L} total",
+                "Client ({}) connected from {}: {:L} total",
                 fd,
+                peer,
                 connection_counter.count()
             );
 
             try {
-                co_await context.connection(std::move(client));
+                if constexpr (server_context_peer<T>) {
+                    co_await context.connection(std::move(client), peer);
+                }
+                else co_await context.connection(std::move(client));
             }
             catch (const std::exception& ex) {
                 TIMBER_ERROR("Client connection closed: {}", ex.what());
@@ -76,7 +133,36 @@ namespace netcore {
             );
         }
 
-        auto listen(server_socket socket) -> ext::task<> {
+        auto listen_priv(const inet_socket& inet) -> ext::task<> {
+            auto addr = netcore::address(inet.host, inet.port);
+
+            auto socket = server_socket(
+                addr->ai_family,
+                addr->ai_socktype,
+                addr->ai_protocol
+            );
+
+            configure(socket);
+            socket.bind(addr);
+
+            co_await serve(std::move(socket));
+        }
+
+        auto listen_priv(const unix_socket& unix_socket) -> ext::task<> {
+            auto socket = server_socket(AF_UNIX, SOCK_STREAM, 0);
+            socket.bind(unix_socket.path);
+
+            unix_socket.apply_permissions();
+
+            // After a handoff, the socket file belongs to the new listener.
+            const auto deferred = ext::scope_exit([&] {
+                if (!handed_off) unix_socket.remove();
+            });
+
+            co_await serve(std::move(socket));
+        }
+
+        auto serve(server_socket socket) -> ext::task<> {
             auto backlog = SOMAXCONN;
             if constexpr (server_context_backlog<T>) backlog = context.backlog;
 
@@ -90,13 +176,19 @@ namespace netcore {
             const auto deferred =
                 ext::scope_exit([this] { this->socket = nullptr; });
 
+            auto peer = peer_address();
+
             while (true) {
                 try {
-                    auto client = co_await socket.accept();
+                    auto client = co_await socket.accept(peer);
 
                     if (!client.valid()) break;
 
-                    handle_connection(std::move(client));
+                    if (!accepted_options.empty()) {
+                        client.configure(accepted_options);
+                    }
+
+                    handle_connection(std::move(client), peer);
                 }
                 catch (const ext::system_error& ex) {
                     switch (ex.code().value()) {
@@ -107,32 +199,6 @@ namespace netcore {
                 }
             }
         }
-
-        auto listen_priv(const inet_socket& inet) -> ext::task<> {
-            auto addr = netcore::address(inet.host, inet.port);
-
-            auto socket = server_socket(
-                addr->ai_family,
-                addr->ai_socktype,
-                addr->ai_protocol
-            );
-
-            socket.bind(addr);
-
-            co_await listen(std::move(socket));
-        }
-
-        auto listen_priv(const unix_socket& unix_socket) -> ext::task<> {
-            auto socket = server_socket(AF_UNIX, SOCK_STREAM, 0);
-            socket.bind(unix_socket.path);
-
-            unix_socket.apply_permissions();
-
-            const auto deferred =
-                ext::scope_exit([&] { unix_socket.remove(); });
-
-            co_await listen(std::move(socket));
-        }
     public:
         T context;
 
@@ -166,21 +232,89 @@ namespace netcore {
             return connection_counter.count();
         }
 
+        // Stops accepting connections and gives open connections until
+        // 'timeout' to finish. Connections still open after that are
+        // cancelled. Returns the number of connections that were still open.
+        // A server can only be drained by one caller at a time.
+        auto drain(std::chrono::milliseconds timeout)
+            -> ext::task<unsigned int> {
+            if (draining) {
+                throw std::runtime_error("Server is already draining");
+            }
+
+            close();
+
+            if (clients.empty()) co_return 0;
+
+            auto timer = netcore::deadline();
+            timer.set(timeout);
+
+            draining = &timer;
+            const auto expired = co_await timer.wait();
+            draining = nullptr;
+
+            if (!expired) co_return 0;
+
+            const auto open = static_cast<unsigned int>(clients.size());
+            auto remaining = std::vector<std::shared_ptr<runtime::event>>();
+            remaining.reserve(clients.size());
+
+            for (const auto& client : clients) {
+                if (auto event = client.lock()) remaining.push_back(event);
+            }
+
+            if (open > 0) {
+                TIMBER_WARNING(
+                    "Cancelling {:L} connection{} on {}",
+                    open,
+                    open == 1 ? "" : "s",
+                    addr
+                );
+            }
+
+            for (const auto& event : remaining) event->cancel();
+
+            co_return open;
+        }
+
+        // Stops accepting connections without removing the socket file, so
+        // that another process can continue listening on the same socket.
+        auto handoff() noexcept -> void {
+            handed_off = true;
+            close();
+        }
+
         auto listen(const endpoint& endpoint) -> ext::jtask<> {
             const auto deferred =
                 ext::scope_exit([this] { addr = std::monostate(); });
 
+            handed_off = false;
+
             co_await std::visit(
                 [&](auto&& arg) { return listen_priv(arg); },
                 endpoint
             );
 
-            if constexpr (server_context_shutdown<T>) context.shutdown();
+            co_await finish();
+        }
 
-            if (connection_counter) co_await connection_counter.await();
-            else co_await yield();
+        // Listens on a socket that has already been bound, such as one
+        // inherited from another process. Its socket file, if any, is left
+        // in place when the server stops.
+        auto listen(server_socket socket) -> ext::jtask<> {
+            const auto deferred =
+                ext::scope_exit([this] { addr = std::monostate(); });
 
-            if constexpr (server_context_close<T>) context.close();
+            if (std::holds_alternative<socket_addr>(socket.address())) {
+                configure(socket);
+            }
+
+            co_await serve(std::move(socket));
+            co_await finish();
+        }
+
+        auto listener() const noexcept -> const server_socket* {
+            return socket;
         }
 
         auto listening() const noexcept -> bool { return socket != nullptr; }
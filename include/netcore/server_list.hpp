@@ -1,10 +1,32 @@
 #pragma once
 
+#include "async_thread_pool.hpp"
+#include "listener_set.hpp"
 #include "server.hpp"
 
+#include <chrono>
+#include <concepts>
 #include <ext/dynarray>
+#include <string_view>
+#include <vector>
 
 namespace netcore {
+    // Configurations with a name take the listener passed under that name
+    // (see listener_set::from_environment()) before matching by endpoint.
+    template <typename T>
+    concept named_endpoint = requires(const T& config) {
+        { config.name } -> std::convertible_to<std::string_view>;
+    };
+
+    struct server_list_options {
+        // Sockets to listen on instead of binding new ones, where they match
+        // a configured endpoint or name.
+        listener_set* listeners = nullptr;
+        // Servers are spread over these threads. Without a pool, they run on
+        // the calling thread.
+        async_thread_pool* threads = nullptr;
+    };
+
     template <server_context Context>
     class server_list final {
         using endpoint_ref =
@@ -13,6 +35,8 @@ namespace netcore {
         struct entry {
             netcore::server<Context> server;
             ext::jtask<> task;
+            async_thread* thread = nullptr;
+            bool failed = false;
 
             template <typename Factory, typename Endpoint>
             entry(Factory& factory, const Endpoint& config, endpoint_ref& out) :
@@ -24,7 +48,49 @@ namespace netcore {
         entry_list entries;
 
         server_list(typename entry_list::size_type count) : entries(count) {}
+
+        // Runs 'f' with the entry's server on the thread that serves it.
+        template <typename F>
+        static auto call(entry& e, F f)
+            -> ext::task<std::invoke_result_t<F&, server<Context>&>> {
+            co_return f(e.server);
+        }
+
+        template <typename F>
+        static auto dispatch(entry& e, F f) -> void {
+            if (e.thread) e.thread->run(call(e, std::move(f)));
+            else f(e.server);
+        }
+
+        template <typename T>
+        static auto on_thread(entry& e, ext::task<T> task) -> ext::jtask<T> {
+            if (e.thread) co_return co_await e.thread->wait(std::move(task));
+            co_return co_await std::move(task);
+        }
+
+        static auto start(
+            entry& e,
+            const netcore::endpoint& endpoint,
+            netcore::fd inherited
+        ) -> ext::task<bool> {
+            if (inherited.valid()) {
+                e.task = e.server.listen(server_socket(inherited.release()));
+            }
+            else e.task = e.server.listen(endpoint);
+
+            if (e.server.listening()) co_return true;
+
+            co_await e.task;
+            co_return false;
+        }
+
+        static auto wait(entry& e) -> ext::task<> {
+            co_await std::move(e.task);
+        }
+
     public:
+        // Endpoints are started concurrently. Those that fail are reported to
+        // 'on_error'; the list is returned as long as any are listening.
         template <typename Factory, typename Endpoint, typename ErrorHandler>
         requires requires(
                      Factory factory,
@@ -43,41 +109,97 @@ namespace netcore {
         static auto listen(
             std::span<Endpoint> configs,
             Factory&& factory,
-            ErrorHandler&& on_error
+            ErrorHandler&& on_error,
+            const server_list_options& options = {}
         ) -> ext::task<server_list> {
             auto list = server_list(configs.size());
             auto& entries = list.entries;
 
+            auto starting = std::vector<ext::jtask<bool>>();
+            starting.reserve(configs.size());
+
             for (auto& config : configs) {
                 auto endpoint = endpoint_ref();
-                auto& [server, task] =
-                    entries.emplace_back(factory, config, endpoint);
+                auto& e = entries.emplace_back(factory, config, endpoint);
 
                 if (!endpoint) throw std::runtime_error("Missing endpoint");
-                task = server.listen(endpoint->get());
 
-                if (server.listening()) continue;
+                auto inherited = netcore::fd();
+                if (options.listeners) {
+                    if constexpr (named_endpoint<Endpoint>) {
+                        const auto name = std::string_view(config.name);
+                        if (!name.empty()) {
+                            inherited = options.listeners->take(name);
+                        }
+                    }
+
+                    if (!inherited.valid()) {
+                        inherited = options.listeners->take(endpoint->get());
+                    }
+                }
+
+                if (options.threads) e.thread = &options.threads->thread();
+
+                auto task = start(e, endpoint->get(), std::move(inherited));
+                starting.push_back(on_thread(e, std::move(task)));
+            }
+
+            std::size_t listening = 0;
 
+            for (std::size_t i = 0; i < starting.size(); ++i) {
                 try {
-                    co_await task;
+                    if (co_await starting[i]) {
+                        ++listening;
+                        continue;
+                    }
                 }
                 catch (...) {
-                    on_error(config, std::current_exception());
+                    on_error(configs[i], std::current_exception());
                 }
 
-                entries.pop_back();
+                entries[i].failed = true;
             }
 
-            if (entries.empty())
+            if (listening == 0)
                 throw std::runtime_error("Failed to listen for connections");
 
             co_return list;
         }
 
+        // Takes over the listening sockets offered by another process over
+        // 'control' (see handoff()). Endpoints without an offered socket
+        // are bound as usual.
+        template <typename Factory, typename Endpoint, typename ErrorHandler>
+        static auto take_over(
+            socket& control,
+            std::span<Endpoint> configs,
+            Factory&& factory,
+            ErrorHandler&& on_error,
+            server_list_options options = {}
+        ) -> ext::task<server_list> {
+            auto inherited = co_await listener_set::receive(control);
+            options.listeners = &inherited;
+
+            auto list = co_await listen(
+                configs,
+                std::forward<Factory>(factory),
+                std::forward<ErrorHandler>(on_error),
+                options
+            );
+
+            co_await listener_set::acknowledge(control);
+            co_return list;
+        }
+
         auto close() noexcept -> void {
-            for (auto& entry : entries) entry.server.close();
+            for (auto& entry : entries) {
+                if (entry.failed) continue;
+                dispatch(entry, [](auto& server) { server.close(); });
+            }
         }
 
+        // With servers spread over threads, the count is only approximate;
+        // see query_connections().
         auto connections() const noexcept -> unsigned int {
             unsigned int count = 0;
 
@@ -88,10 +210,80 @@ namespace netcore {
             return count;
         }
 
+        // Drains every server concurrently (see server::drain()) and returns
+        // the total number of cancelled connections.
+        auto drain(std::chrono::milliseconds timeout)
+            -> ext::task<unsigned int> {
+            auto draining = std::vector<ext::jtask<unsigned int>>();
+
+            for (auto& entry : entries) {
+                if (entry.failed) continue;
+                draining.push_back(
+                    on_thread(entry, entry.server.drain(timeout))
+                );
+            }
+
+            unsigned int cancelled = 0;
+            for (auto& task : draining) cancelled += co_await task;
+
+            co_return cancelled;
+        }
+
+        // Offers the listening sockets to another process over 'control'.
+        // Once it is accepting connections, these servers stop accepting and
+        // drain their connections as if closed. The kernel's backlog is
+        // shared by both processes throughout, so no connection is refused.
+        auto handoff(socket& control) -> ext::task<bool> {
+            auto fds = std::vector<int>();
+
+            for (auto& entry : entries) {
+                if (entry.failed) continue;
+
+                auto task = call(entry, [](auto& server) {
+                    const auto* listener = server.listener();
+                    return listener ? listener->fd() : -1;
+                });
+
+                auto listener = on_thread(entry, std::move(task));
+                const auto fd = co_await listener;
+
+                if (fd != -1) fds.push_back(fd);
+            }
+
+            if (!co_await listener_set::offer(control, fds)) co_return false;
+
+            for (auto& entry : entries) {
+                if (entry.failed) continue;
+                dispatch(entry, [](auto& server) { server.handoff(); });
+            }
+
+            co_return true;
+        }
+
+        // Waits for every server to stop, rethrowing the first error.
         auto join() -> ext::task<> {
-            for (auto&& entry : entries) co_await std::move(entry.task);
+            auto joining = std::vector<ext::jtask<>>();
+            auto error = std::exception_ptr();
+
+            for (auto& entry : entries) {
+                if (entry.failed) continue;
+                joining.push_back(on_thread(entry, wait(entry)));
+            }
+
+            for (auto& task : joining) {
+                try {
+                    co_await task;
+                }
+                catch (...) {
+                    if (!error) error = std::current_exception();
+                }
+            }
+
+            if (error) std::rethrow_exception(error);
         }
 
+        // Like connections(), this is only approximate with a thread pool; see
+        // query_listening().
         auto listening() const noexcept -> std::size_t {
             std::size_t result = 0;
 
@@ -101,5 +293,41 @@ namespace netcore {
 
             return result;
         }
+
+        // Counts connections on the threads that serve them, so the result
+        // is exact even when servers run on a thread pool.
+        auto query_connections() -> ext::task<unsigned int> {
+            unsigned int count = 0;
+
+            for (auto& entry : entries) {
+                if (entry.failed) continue;
+
+                auto task = call(entry, [](auto& server) {
+                    return server.connections();
+                });
+
+                auto connections = on_thread(entry, std::move(task));
+                count += co_await connections;
+            }
+
+            co_return count;
+        }
+
+        auto query_listening() -> ext::task<std::size_t> {
+            std::size_t result = 0;
+
+            for (auto& entry : entries) {
+                if (entry.failed) continue;
+
+                auto task = call(entry, [](auto& server) {
+                    return server.listening();
+                });
+
+                auto listening = on_thread(entry, std::move(task));
+                if (co_await listening) ++result;
+            }
+
+            co_return result;
+        }
     };
 }
@@ -12,10 +12,22 @@ namespace netcore {
         std::shared_ptr<runtime::event> event;
         address_type addr;
     public:
+        // Adopts a socket that has already been bound, such as one inherited
+        // from another process.
+        explicit server_socket(int fd);
+
         server_socket(int domain, int type, int protocol);
 
+        server_socket(server_socket&&) = default;
+
+        ~server_socket();
+
+        auto operator=(server_socket&&) -> server_socket& = default;
+
         auto accept() -> ext::task<socket>;
 
+        auto accept(peer_address& peer) -> ext::task<socket>;
+
         auto address() const noexcept -> const address_type&;
 
         auto bind(const netcore::address& address) -> void;
@@ -24,6 +36,8 @@ namespace netcore {
 
         auto cancel() -> void;
 
+        auto configure(const socket_options& options) -> void;
+
         auto fd() const noexcept -> int;
 
         auto listen(int backlog) -> void;
@@ -2,21 +2,35 @@
 
 #include "fd.hpp"
 #include "runtime.hpp"
+#include "socket_options.hpp"
 
+#include <chrono>
+#include <cstdint>
 #include <ext/coroutine>
 #include <fmt/format.h>
+#include <optional>
+#include <span>
 #include <sstream>
 #include <string>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <vector>
 
 namespace netcore {
     class socket {
         netcore::fd descriptor;
         bool error = false;
         std::shared_ptr<runtime::event> event;
+        bool zerocopy = false;
+        std::uint32_t zerocopy_sent = 0;
+        std::uint32_t zerocopy_completed = 0;
+
+        auto await_connect() -> ext::task<bool>;
 
         [[noreturn]]
         auto failure(const char* message) -> void;
+
+        auto read_zerocopy_completions() -> bool;
     public:
         socket() = default;
 
@@ -28,9 +42,31 @@ namespace netcore {
 
         auto await_write() -> ext::task<>;
 
+        auto await_zerocopy() -> ext::task<>;
+
         auto cancel() noexcept -> void;
 
-        auto connect(const sockaddr* addr, socklen_t len) -> ext::task<bool>;
+        // Allows the socket to be cancelled from elsewhere for as long as it
+        // remains open, even after it has been moved.
+        auto cancellation() const noexcept -> std::weak_ptr<runtime::event>;
+
+        auto configure(const socket_options& options) -> void;
+
+        auto connect(
+            const sockaddr* addr,
+            socklen_t len,
+            std::optional<std::chrono::milliseconds> timeout = std::nullopt
+        ) -> ext::task<bool>;
+
+        auto connect_with_data(
+            const sockaddr* addr,
+            socklen_t len,
+            std::span<const std::byte> data
+        ) -> ext::task<std::optional<std::size_t>>;
+
+        auto cork(bool enable) -> bool;
+
+        auto enable_zerocopy() -> bool;
 
         auto end() const -> void;
 
@@ -40,19 +76,45 @@ namespace netcore {
 
         auto read(void* dest, std::size_t len) -> ext::task<std::size_t>;
 
+        // Receives data along with any file descriptors sent with it. Only
+        // meaningful for unix domain sockets.
+        auto receive_fds(
+            void* dest,
+            std::size_t len,
+            std::vector<netcore::fd>& fds
+        ) -> ext::task<std::size_t>;
+
         auto release()
             -> std::pair<netcore::fd, std::shared_ptr<runtime::event>>;
 
+        // Sends file descriptors with the first byte of 'src', which must
+        // not be empty.
+        auto send_fds(
+            std::span<const int> fds,
+            const void* src,
+            std::size_t len
+        ) -> ext::task<std::size_t>;
+
         auto sendfile(const netcore::fd& descriptor, std::size_t count)
             -> ext::task<>;
 
+        auto sendfile(
+            const netcore::fd& descriptor,
+            std::size_t offset,
+            std::size_t count
+        ) -> ext::task<>;
+
         auto try_read(void* dest, std::size_t len) -> long;
 
         auto try_write(const void* src, std::size_t len) -> long;
 
+        auto try_writev(const iovec* iov, std::size_t count) -> long;
+
         auto valid() const -> bool;
 
         auto write(const void* src, std::size_t len) -> ext::task<std::size_t>;
+
+        auto write_zerocopy(const void* src, std::size_t len) -> ext::task<>;
     };
 }
 
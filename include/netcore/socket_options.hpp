@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+namespace netcore {
+    struct socket_options {
+        std::optional<std::chrono::microseconds> busy_poll;
+        std::optional<std::chrono::seconds> defer_accept;
+        std::optional<int> fastopen;
+        std::optional<bool> keepalive;
+        std::optional<int> keepalive_count;
+        std::optional<std::chrono::seconds> keepalive_idle;
+        std::optional<std::chrono::seconds> keepalive_interval;
+        std::optional<bool> nodelay;
+        std::optional<int> notsent_lowat;
+        std::optional<bool> quickack;
+        std::optional<int> receive_buffer;
+        std::optional<bool> reuse_port;
+        std::optional<int> send_buffer;
+
+        // Options that accepted sockets do not inherit from their listener.
+        auto accepted() const -> socket_options;
+
+        auto empty() const noexcept -> bool;
+    };
+
+    auto configure(int fd, const socket_options& options) -> void;
+}
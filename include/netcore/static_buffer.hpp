@@ -0,0 +1,117 @@
+#pragma once
+
+#include "buffer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <span>
+
+namespace netcore {
+    template <std::size_t Capacity>
+    class static_buffer final {
+        static_assert(Capacity > 0, "static buffer capacity must be nonzero");
+
+        std::array<std::byte, Capacity> storage;
+        std::size_t head = 0;
+        std::size_t tail = 0;
+    public:
+        static constexpr auto capacity() noexcept -> std::size_t {
+            return Capacity;
+        }
+
+        auto append(std::size_t bytes) noexcept -> void { tail += bytes; }
+
+        auto available() const noexcept -> std::size_t {
+            return Capacity - tail;
+        }
+
+        auto back() const noexcept -> const std::byte* {
+            return storage.data() + tail;
+        }
+
+        auto back() noexcept -> std::byte* { return storage.data() + tail; }
+
+        auto clear() noexcept -> void {
+            head = 0;
+            tail = 0;
+        }
+
+        auto compact() noexcept -> void {
+            if (head == 0) return;
+
+            const auto len = size();
+
+            std::memmove(storage.data(), front(), len);
+            head = 0;
+            tail = len;
+        }
+
+        auto consume(std::size_t bytes) noexcept -> void {
+            head += bytes;
+            if (head == tail) clear();
+        }
+
+        auto data() const noexcept -> std::span<const std::byte> {
+            return {front(), size()};
+        }
+
+        auto empty() const noexcept -> bool { return head == tail; }
+
+        auto front() const noexcept -> const std::byte* {
+            return storage.data() + head;
+        }
+
+        auto front() noexcept -> std::byte* { return storage.data() + head; }
+
+        auto full() const noexcept -> bool { return tail == Capacity; }
+
+        auto read() noexcept -> std::span<const std::byte> {
+            auto result = data();
+            consume(size());
+            return result;
+        }
+
+        auto read(std::size_t len) noexcept -> std::span<const std::byte> {
+            len = std::min(size(), len);
+            auto result = std::span<const std::byte>(front(), len);
+            consume(len);
+            return result;
+        }
+
+        auto read(void* dest, std::size_t len) noexcept -> std::size_t {
+            len = std::min(len, size());
+
+            std::memcpy(dest, front(), len);
+            consume(len);
+
+            return len;
+        }
+
+        auto size() const noexcept -> std::size_t { return tail - head; }
+
+        auto write(const void* src, std::size_t len) noexcept -> std::size_t {
+            len = std::min(len, available());
+
+            std::memcpy(back(), src, len);
+            append(len);
+
+            return len;
+        }
+    };
+
+    namespace detail {
+        template <std::size_t Capacity>
+        struct buffer_type {
+            using type = static_buffer<Capacity>;
+        };
+
+        template <>
+        struct buffer_type<0> {
+            using type = buffer;
+        };
+    }
+
+    template <std::size_t Capacity>
+    using buffer_type = typename detail::buffer_type<Capacity>::type;
+}
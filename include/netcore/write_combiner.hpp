@@ -0,0 +1,172 @@
+#pragma once
+
+#include "detail/awaiter.hpp"
+#include "runtime.hpp"
+
+#include <array>
+#include <ext/coroutine>
+#include <sys/uio.h>
+
+namespace netcore {
+    template <typename T>
+    concept vectored_sink =
+        requires(T t, const iovec* iov, std::size_t count) {
+            { t.await_write() } -> std::same_as<ext::task<>>;
+
+            { t.try_writev(iov, count) } -> std::convertible_to<long>;
+        };
+
+    template <vectored_sink Sink>
+    class write_combiner final {
+        static constexpr auto batch_size = std::size_t(64);
+
+        struct frame {
+            const std::byte* data;
+            std::size_t size;
+            frame* next = nullptr;
+            detail::awaiter awaiter;
+            bool done = false;
+            bool flush = false;
+        };
+
+        class awaitable {
+            frame& f;
+        public:
+            awaitable(frame& f) : f(f) {}
+
+            auto await_ready() const noexcept -> bool { return false; }
+
+            auto await_suspend(std::coroutine_handle<> coroutine) -> void {
+                f.awaiter.coroutine = coroutine;
+            }
+
+            auto await_resume() -> void {
+                if (f.awaiter.exception) {
+                    std::rethrow_exception(f.awaiter.exception);
+                }
+            }
+        };
+
+        Sink* sink;
+        frame* head = nullptr;
+        frame* tail = nullptr;
+        bool flushing = false;
+
+        auto complete(std::size_t bytes) -> void {
+            while (bytes > 0) {
+                if (bytes < head->size) {
+                    head->data += bytes;
+                    head->size -= bytes;
+                    return;
+                }
+
+                bytes -= head->size;
+                resume(pop());
+            }
+        }
+
+        // Writes queued frames until the flusher's own frame is done, then
+        // hands the rest to the next writer so that no caller waits on
+        // frames queued after its own.
+        auto drain(frame& own) -> ext::task<> {
+            auto iov = std::array<iovec, batch_size>();
+
+            while (!own.done) {
+                std::size_t count = 0;
+
+                for (auto* f = head; f && count < iov.size(); f = f->next) {
+                    iov[count++] = {
+                        .iov_base = const_cast<std::byte*>(f->data),
+                        .iov_len = f->size};
+                }
+
+                const auto written = sink->try_writev(iov.data(), count);
+
+                if (written == -1) co_await sink->await_write();
+                else complete(written);
+            }
+
+            if (!head) {
+                flushing = false;
+                co_return;
+            }
+
+            head->flush = true;
+            runtime::current().enqueue(head->awaiter);
+        }
+
+        auto fail(std::exception_ptr exception) noexcept -> void {
+            while (head) {
+                auto* const f = pop();
+                f->awaiter.exception = exception;
+                resume(f);
+            }
+        }
+
+        auto pop() noexcept -> frame* {
+            auto* const f = head;
+
+            head = f->next;
+            if (!head) tail = nullptr;
+
+            return f;
+        }
+
+        auto push(frame& f) noexcept -> void {
+            if (tail) tail->next = &f;
+            else head = &f;
+
+            tail = &f;
+        }
+
+        // The flushing writer's own frame has no coroutine to resume: it is
+        // still running the drain loop.
+        auto resume(frame* f) -> void {
+            f->done = true;
+            if (f->awaiter.coroutine) runtime::current().enqueue(f->awaiter);
+        }
+    public:
+        write_combiner(Sink& sink) : sink(&sink) {}
+
+        write_combiner(const write_combiner&) = delete;
+
+        write_combiner(write_combiner&&) = delete;
+
+        auto operator=(const write_combiner&) -> write_combiner& = delete;
+
+        auto operator=(write_combiner&&) -> write_combiner& = delete;
+
+        auto pending() const noexcept -> bool { return head != nullptr; }
+
+        auto write(const void* src, std::size_t len) -> ext::task<> {
+            if (len == 0) co_return;
+
+            auto f = frame {
+                .data = static_cast<const std::byte*>(src),
+                .size = len};
+
+            push(f);
+
+            if (flushing) {
+                co_await awaitable(f);
+                if (!f.flush) co_return;
+
+                // The previous flusher handed over the queue.
+                f.awaiter.coroutine = nullptr;
+            }
+
+            flushing = true;
+
+            try {
+                co_await drain(f);
+            }
+            catch (...) {
+                flushing = false;
+                fail(std::current_exception());
+                throw;
+            }
+        }
+
+        auto write_to(Sink& sink) noexcept -> void { this->sink = &sink; }
+    };
+}
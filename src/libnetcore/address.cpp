@@ -1,18 +1,23 @@
 #include <netcore/address.hpp>
 
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstddef>
 #include <cstring>
 #include <ext/except.h>
+#include <string_view>
+#include <sys/un.h>
 
 namespace {
     constexpr auto error_message = "failed to determine internet address";
 }
 
 namespace netcore {
-    address::address(std::string_view host, std::string_view port) {
+    address::address(std::string_view host, std::string_view port, int type) {
         auto hints = addrinfo();
         std::memset(&hints, 0, sizeof(hints));
         hints.ai_family = AF_UNSPEC;
-        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_socktype = type;
 
         if (host.empty()) hints.ai_flags = AI_PASSIVE;
 
@@ -85,4 +90,129 @@ namespace netcore {
     }
 
     auto socket_addr::port() const noexcept -> unsigned short { return port_; }
+
+    peer_address::peer_address() noexcept {
+        std::memset(&storage, 0, sizeof(storage));
+    }
+
+    peer_address::peer_address(const sockaddr* addr, socklen_t len) noexcept :
+        peer_address() {
+        this->len = std::min<socklen_t>(len, sizeof(storage));
+        std::memcpy(&storage, addr, this->len);
+    }
+
+    auto peer_address::operator==(const peer_address& other) const noexcept
+        -> bool {
+        return same_host(other) && port() == other.port();
+    }
+
+    auto peer_address::capacity() const noexcept -> socklen_t {
+        return sizeof(storage);
+    }
+
+    auto peer_address::data() const noexcept -> const sockaddr* {
+        return reinterpret_cast<const sockaddr*>(&storage);
+    }
+
+    auto peer_address::data() noexcept -> sockaddr* {
+        return reinterpret_cast<sockaddr*>(&storage);
+    }
+
+    auto peer_address::empty() const noexcept -> bool { return len == 0; }
+
+    auto peer_address::family() const noexcept -> int {
+        return len == 0 ? AF_UNSPEC : storage.ss_family;
+    }
+
+    auto peer_address::hash() const noexcept -> std::size_t {
+        const auto seed = host_hash();
+        return seed ^ (port() + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+
+    auto peer_address::host(host_buffer& buffer) const noexcept
+        -> std::string_view {
+        const void* src = nullptr;
+
+        switch (family()) {
+            case AF_INET:
+                src = &reinterpret_cast<const sockaddr_in*>(&storage)->sin_addr;
+                break;
+            case AF_INET6:
+                src =
+                    &reinterpret_cast<const sockaddr_in6*>(&storage)->sin6_addr;
+                break;
+            default: return {};
+        }
+
+        if (!inet_ntop(family(), src, buffer.data(), buffer.size())) return {};
+        return buffer.data();
+    }
+
+    auto peer_address::host_bytes() const noexcept -> std::string_view {
+        const void* bytes = nullptr;
+        std::size_t size = 0;
+
+        switch (family()) {
+            case AF_INET:
+                bytes =
+                    &reinterpret_cast<const sockaddr_in*>(&storage)->sin_addr;
+                size = sizeof(in_addr);
+                break;
+            case AF_INET6:
+                bytes =
+                    &reinterpret_cast<const sockaddr_in6*>(&storage)->sin6_addr;
+                size = sizeof(in6_addr);
+                break;
+            case AF_UNIX: return path();
+            default:
+                bytes = &storage;
+                size = len;
+        }
+
+        return std::string_view(static_cast<const char*>(bytes), size);
+    }
+
+    auto peer_address::host_hash() const noexcept -> std::size_t {
+        const auto seed = std::hash<std::string_view>()(host_bytes());
+        return seed ^ (family() + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+
+    auto peer_address::path() const noexcept -> std::string_view {
+        if (family() != AF_UNIX) return {};
+
+        const auto* const addr = reinterpret_cast<const sockaddr_un*>(&storage);
+        const auto offset = offsetof(sockaddr_un, sun_path);
+
+        if (len <= offset) return {};
+
+        return std::string_view(
+            addr->sun_path,
+            strnlen(addr->sun_path, len - offset)
+        );
+    }
+
+    auto peer_address::port() const noexcept -> unsigned short {
+        switch (family()) {
+            case AF_INET:
+                return ntohs(
+                    reinterpret_cast<const sockaddr_in*>(&storage)->sin_port
+                );
+            case AF_INET6:
+                return ntohs(
+                    reinterpret_cast<const sockaddr_in6*>(&storage)->sin6_port
+                );
+            default: return 0;
+        }
+    }
+
+    auto peer_address::resize(socklen_t len) noexcept -> void {
+        this->len = std::min<socklen_t>(len, sizeof(storage));
+    }
+
+    auto peer_address::same_host(const peer_address& other) const noexcept
+        -> bool {
+        return family() == other.family() && host_bytes() == other.host_bytes();
+    }
+
+    auto peer_address::size() const noexcept -> socklen_t { return len; }
 }
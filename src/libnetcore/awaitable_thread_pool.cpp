@@ -1,4 +1,5 @@
 #include <netcore/awaitable_thread_pool.hpp>
+#include <netcore/runtime.hpp>
 
 #include <timber/timber>
 
@@ -10,8 +11,7 @@ namespace netcore {
         std::size_t size,
         std::size_t backlog_scale_factor
     ) :
-        pool(name, size, backlog_scale_factor),
-        task(wait_for_events()) {}
+        pool(name, size, backlog_scale_factor) {}
 
     auto awaitable_thread_pool::enqueue(node& node) -> void {
         {
@@ -28,11 +28,14 @@ namespace netcore {
     auto awaitable_thread_pool::resume() -> void {
         auto* current = take_nodes();
 
+        // Waiters are resumed by the runtime rather than from this task, so
+        // that they are free to destroy the pool.
         while (current) {
-            const auto coroutine = current->coroutine;
-            current = current->next;
+            auto& waiter = *current;
+            current = std::exchange(waiter.next, nullptr);
 
-            coroutine.resume();
+            --outstanding;
+            runtime::current().enqueue(waiter);
         }
     }
 
@@ -40,8 +43,14 @@ namespace netcore {
         pool.run(std::move(job));
     }
 
+    auto awaitable_thread_pool::start() -> void {
+        // Events are only awaited while jobs are outstanding, so that an
+        // idle pool does not keep the runtime running.
+        if (outstanding++ == 0) task = wait_for_events();
+    }
+
     auto awaitable_thread_pool::wait_for_events() -> ext::jtask<> {
-        while (true) {
+        while (outstanding > 0) {
             co_await event.wait();
             resume();
         }
@@ -0,0 +1,215 @@
+#include <netcore/balanced_client.hpp>
+#include <netcore/server_socket.hpp>
+#include <netcore/timer.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+    struct connection {
+        netcore::buffered_socket socket;
+        bool broken = false;
+
+        connection(netcore::buffered_socket&& socket) :
+            socket(std::move(socket)) {}
+
+        auto connected() -> bool { return !broken; }
+
+        auto failed() -> bool { return broken; }
+    };
+
+    using client_type = netcore::balanced_client<connection>;
+
+    auto listener(bool listening = true) -> netcore::server_socket {
+        const auto addr = netcore::address("127.0.0.1", "0");
+
+        auto socket = netcore::server_socket(addr->ai_family, SOCK_STREAM, 0);
+        socket.bind(addr);
+        if (listening) socket.listen(8);
+
+        return socket;
+    }
+
+    // Accepts a connection that the client has already opened.
+    auto accepted(const netcore::server_socket& socket) -> bool {
+        const auto fd = ::accept4(socket.fd(), nullptr, nullptr, SOCK_NONBLOCK);
+        if (fd == -1) return false;
+
+        ::close(fd);
+        return true;
+    }
+
+    auto endpoint(const netcore::server_socket& socket) -> std::string {
+        auto bound = sockaddr_in();
+        auto len = socklen_t(sizeof(bound));
+        getsockname(socket.fd(), reinterpret_cast<sockaddr*>(&bound), &len);
+
+        return fmt::format("127.0.0.1:{}", ntohs(bound.sin_port));
+    }
+}
+
+class BalancedClientTest : public testing::Test {
+protected:
+    netcore::server_socket first = listener();
+    netcore::server_socket second = listener();
+    netcore::server_socket refused = listener(false);
+};
+
+TEST_F(BalancedClientTest, LeastOutstanding) {
+    netcore::run([&]() -> ext::task<> {
+        const auto endpoints =
+            std::vector<std::string> {endpoint(first), endpoint(second)};
+
+        auto client = client_type(
+            endpoints,
+            1024,
+            {.strategy = netcore::balance_strategy::least_outstanding}
+        );
+
+        {
+            const auto a = co_await client.connect();
+            const auto b = co_await client.connect();
+
+            EXPECT_NE(a.endpoint(), b.endpoint());
+            EXPECT_EQ(2, client.outstanding());
+        }
+
+        EXPECT_EQ(0, client.outstanding());
+    }());
+}
+
+TEST_F(BalancedClientTest, PowerOfTwo) {
+    netcore::run([&]() -> ext::task<> {
+        const auto endpoints =
+            std::vector<std::string> {endpoint(first), endpoint(second)};
+
+        auto client = client_type(endpoints, 1024);
+
+        {
+            const auto a = co_await client.connect();
+            const auto b = co_await client.connect();
+
+            // With two endpoints, both are always compared.
+            EXPECT_NE(a.endpoint(), b.endpoint());
+        }
+    }());
+}
+
+TEST_F(BalancedClientTest, Ejection) {
+    netcore::run([&]() -> ext::task<> {
+        const auto endpoints =
+            std::vector<std::string> {endpoint(refused), endpoint(first)};
+
+        auto client = client_type(
+            endpoints,
+            1024,
+            {.strategy = netcore::balance_strategy::least_outstanding,
+             .failure_threshold = 1}
+        );
+
+        EXPECT_THROW(co_await client.connect(), std::system_error);
+
+        for (auto i = 0; i < 3; ++i) {
+            const auto item = co_await client.connect();
+            EXPECT_EQ(endpoint(first), item.endpoint());
+        }
+    }());
+}
+
+TEST_F(BalancedClientTest, Update) {
+    netcore::run([&]() -> ext::task<> {
+        auto client = client_type(
+            std::vector<std::string> {endpoint(first)},
+            1024
+        );
+
+        auto item = co_await client.connect();
+        EXPECT_EQ(endpoint(first), item.endpoint());
+
+        client.update(std::vector<std::string> {endpoint(second)});
+        EXPECT_EQ(
+            std::vector<std::string> {endpoint(second)},
+            client.endpoints()
+        );
+
+        // Connections to removed endpoints remain usable.
+        EXPECT_TRUE(item->connected());
+        item = {};
+
+        EXPECT_EQ(endpoint(second), (co_await client.connect()).endpoint());
+    }());
+}
+
+TEST_F(BalancedClientTest, UpdateKeepsEndpoints) {
+    netcore::run([&]() -> ext::task<> {
+        const auto kept =
+            std::vector<std::string> {endpoint(first), endpoint(second)};
+
+        auto client = client_type(kept, 1024);
+        const auto item = co_await client.connect();
+
+        client.update(std::vector<std::string> {
+            endpoint(first),
+            endpoint(second),
+            endpoint(refused),
+            endpoint(first)});
+
+        EXPECT_EQ(
+            (std::vector<std::string> {
+                endpoint(first),
+                endpoint(second),
+                endpoint(refused)}),
+            client.endpoints()
+        );
+
+        // Kept endpoints still track their outstanding connections.
+        EXPECT_EQ(1, client.outstanding());
+    }());
+}
+
+TEST_F(BalancedClientTest, Maintain) {
+    netcore::run([&]() -> ext::task<> {
+        auto client = client_type(
+            std::vector<std::string> {endpoint(first)},
+            1024,
+            {},
+            {.min_idle = 1}
+        );
+
+        const auto maintenance = client.maintain();
+        co_await netcore::sleep_for(10ms);
+
+        // Endpoints added later are maintained as well.
+        client.update(std::vector<std::string> {
+            endpoint(first),
+            endpoint(second)});
+        co_await netcore::sleep_for(10ms);
+
+        EXPECT_TRUE(accepted(first));
+        EXPECT_TRUE(accepted(second));
+
+        // Removed endpoints stop being maintained.
+        client.update(std::vector<std::string> {endpoint(second)});
+
+        client.stop();
+        co_await maintenance;
+    }());
+}
+
+TEST_F(BalancedClientTest, Warm) {
+    netcore::run([&]() -> ext::task<> {
+        auto client = client_type(
+            std::vector<std::string> {endpoint(first), endpoint(second)},
+            1024,
+            {},
+            {.min_idle = 1}
+        );
+
+        co_await client.warm();
+
+        EXPECT_TRUE(accepted(first));
+        EXPECT_TRUE(accepted(second));
+        EXPECT_FALSE(accepted(first));
+    }());
+}
@@ -27,6 +27,16 @@ namespace netcore {
         tail = 0;
     }
 
+    auto buffer::compact() noexcept -> void {
+        if (head == 0) return;
+
+        const auto len = size();
+
+        std::memmove(storage.get(), front(), len);
+        head = 0;
+        tail = len;
+    }
+
     auto buffer::consume(std::size_t bytes) -> void {
         head += bytes;
         if (head == tail) clear();
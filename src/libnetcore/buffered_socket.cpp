@@ -12,7 +12,9 @@ namespace netcore {
     buffered_socket::buffered_socket(buffered_socket&& other) :
         inner(std::move(other.inner)),
         reader(std::move(other.reader)),
-        writer(std::move(other.writer)) {
+        writer(std::move(other.writer)),
+        corked(std::exchange(other.corked, false)),
+        corkable(other.corkable) {
         reader.read_from(inner);
         writer.write_to(inner);
     }
@@ -27,18 +29,38 @@ namespace netcore {
         return *this;
     }
 
+    auto buffered_socket::await_writable() -> ext::task<> {
+        return writer.await_writable();
+    }
+
     auto buffered_socket::await_write() -> ext::task<> {
         return writer.await_write();
     }
 
+    auto buffered_socket::buffered() const noexcept -> std::size_t {
+        return writer.buffered();
+    }
+
     auto buffered_socket::cancel() noexcept -> void { inner.cancel(); }
 
+    auto buffered_socket::capacity() const noexcept -> std::size_t {
+        return reader.capacity();
+    }
+
+    auto buffered_socket::cork() -> void {
+        if (corked || !corkable) return;
+
+        if (inner.cork(true)) corked = true;
+        else corkable = false;
+    }
+
     auto buffered_socket::connect(
         const endpoint& endpoint,
-        std::size_t buffer_size
+        std::size_t buffer_size,
+        const connect_options& options
     ) -> ext::task<buffered_socket> {
         co_return buffered_socket(
-            co_await netcore::connect(endpoint),
+            co_await netcore::connect(endpoint, options),
             buffer_size
         );
     }
@@ -59,12 +81,20 @@ namespace netcore {
         return reader.fill_buffer();
     }
 
-    auto buffered_socket::flush() -> ext::task<> { return writer.flush(); }
+    auto buffered_socket::flush() -> ext::task<> {
+        co_await writer.flush();
+        uncork();
+    }
 
     auto buffered_socket::peek() -> ext::task<std::span<const std::byte>> {
         return reader.peek();
     }
 
+    auto buffered_socket::peek(std::size_t len)
+        -> ext::task<std::span<const std::byte>> {
+        return reader.peek(len);
+    }
+
     auto buffered_socket::read() -> ext::task<std::span<const std::byte>> {
         return reader.read();
     }
@@ -82,17 +112,82 @@ namespace netcore {
         const netcore::fd& descriptor,
         std::size_t count
     ) -> ext::task<> {
-        co_await flush();
-        co_await inner.sendfile(descriptor, count);
+        return sendfile(descriptor, 0, count);
+    }
+
+    auto buffered_socket::sendfile(
+        const netcore::fd& descriptor,
+        std::size_t offset,
+        std::size_t count
+    ) -> ext::task<> {
+        cork();
+        co_await writer.flush();
+        co_await inner.sendfile(descriptor, offset, count);
+        uncork();
+    }
+
+    auto buffered_socket::sendfile(
+        const std::filesystem::path& path,
+        std::size_t offset,
+        std::size_t count
+    ) -> ext::task<> {
+        const auto file = file_cache::current().open(path);
+        const auto size = static_cast<std::size_t>(file->status.st_size);
+
+        if (offset > size || count > size - offset) {
+            throw std::out_of_range(fmt::format(
+                R"(range [{}, {}) exceeds size of file "{}" ({:L} bytes))",
+                offset,
+                offset + count,
+                path.native(),
+                size
+            ));
+        }
+
+        cork();
+        co_await writer.flush();
+        co_await inner.sendfile(file->descriptor, offset, count);
+        uncork();
     }
 
     auto buffered_socket::try_write(const void* src, std::size_t len)
         -> std::size_t {
+        cork();
         return writer.try_write(src, len);
     }
 
+    auto buffered_socket::try_writev(const iovec* iov, std::size_t count)
+        -> long {
+        if (!writer.try_flush()) return -1;
+        return inner.try_writev(iov, count);
+    }
+
+    auto buffered_socket::uncork() -> void {
+        if (!corked) return;
+
+        corked = false;
+        inner.cork(false);
+    }
+
+    auto buffered_socket::watermarks(std::size_t low, std::size_t high)
+        -> void {
+        writer.watermarks(low, high);
+    }
+
+    auto buffered_socket::writable() const noexcept -> bool {
+        return writer.writable();
+    }
+
     auto buffered_socket::write(const void* src, std::size_t len)
         -> ext::task<> {
+        cork();
         return writer.write(src, len);
     }
+
+    auto buffered_socket::zerocopy(std::size_t threshold) -> bool {
+        if (!inner.enable_zerocopy()) return false;
+
+        writer.zerocopy(threshold);
+        return true;
+    }
 }
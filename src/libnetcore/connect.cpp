@@ -1,46 +1,248 @@
 #include <netcore/address.hpp>
 #include <netcore/connect.hpp>
+#include <netcore/deadline.hpp>
+#include <netcore/except.hpp>
+#include <netcore/resolver.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <ext/except.h>
 #include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <timber/timber>
+#include <vector>
 
-namespace netcore {
-    auto connect(std::string_view host, std::string_view port)
-        -> ext::task<socket> {
-        auto addr = address(host, port);
+namespace {
+    // Orders addresses by alternating between address families, starting
+    // with the family of the first result.
+    auto interleave(const netcore::address& addr)
+        -> std::vector<const addrinfo*> {
+        auto preferred = std::vector<const addrinfo*>();
+        auto other = std::vector<const addrinfo*>();
+
+        for (const auto* res = &*addr; res; res = res->ai_next) {
+            if (res->ai_family == addr->ai_family) preferred.push_back(res);
+            else other.push_back(res);
+        }
+
+        auto result = std::vector<const addrinfo*>();
+        result.reserve(preferred.size() + other.size());
+
+        const auto count = std::max(preferred.size(), other.size());
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (i < preferred.size()) result.push_back(preferred[i]);
+            if (i < other.size()) result.push_back(other[i]);
+        }
+
+        return result;
+    }
+
+    auto write_all(netcore::socket& socket, std::span<const std::byte> data)
+        -> ext::task<> {
+        while (!data.empty()) {
+            data = data.subspan(
+                co_await socket.write(data.data(), data.size())
+            );
+        }
+    }
+
+    // Connects to the first address that answers, racing addresses as
+    // described in RFC 8305. If 'data' is not empty, it is sent with the
+    // SYN where TCP Fast Open allows, and otherwise once connected.
+    auto connect_inet(
+        std::string_view host,
+        std::string_view port,
+        std::span<const std::byte> data,
+        const netcore::connect_options& options
+    ) -> ext::task<netcore::socket> {
+        struct attempt {
+            const addrinfo* info;
+            netcore::socket socket;
+            ext::jtask<> task;
+            std::size_t sent = 0;
+            bool started = false;
+            bool finished = false;
+        };
+
+        auto* resolver = options.resolver;
+        if (!resolver) resolver = &netcore::resolver::current();
+
+        const auto addr = co_await resolver->resolve(host, port);
+
+        auto attempts = std::vector<attempt>();
+
+        for (const auto* res : interleave(*addr)) {
+            attempts.push_back({.info = res});
+        }
+
+        auto timer = netcore::deadline();
+        auto winner = std::optional<std::size_t>();
+        auto failed = false;
+
+        // The last real failure: an errno, or an exception that carries none.
+        auto error = 0;
+        auto failure = std::exception_ptr();
+        std::size_t next = 0;
+        std::size_t pending = 0;
 
-        for (auto* res = addr.get(); res != nullptr; res = res->ai_next) {
-            auto sock =
-                socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+        const auto start = [&](attempt& a) -> ext::jtask<> {
+            auto connected = false;
 
-            if (co_await sock.connect(res->ai_addr, res->ai_addrlen)) {
-                TIMBER_DEBUG(
-                    "{} connected to {}",
-                    sock,
-                    socket_addr(res->ai_addr, res->ai_addrlen)
+            try {
+                a.socket = netcore::socket(
+                    a.info->ai_family,
+                    a.info->ai_socktype,
+                    a.info->ai_protocol
                 );
 
-                co_return sock;
+                if (data.empty()) {
+                    connected = co_await a.socket.connect(
+                        a.info->ai_addr,
+                        a.info->ai_addrlen
+                    );
+                }
+                else {
+                    const auto sent = co_await a.socket.connect_with_data(
+                        a.info->ai_addr,
+                        a.info->ai_addrlen,
+                        data
+                    );
+
+                    connected = sent.has_value();
+                    if (sent) a.sent = *sent;
+                }
+
+                if (!connected) {
+                    error = errno;
+                    failure = nullptr;
+                }
+            }
+            catch (const netcore::task_canceled&) {
+                // Another attempt won, or the connection timed out.
+            }
+            catch (const std::system_error& ex) {
+                TIMBER_DEBUG("connection attempt failed: {}", ex.what());
+
+                error = ex.code().value();
+                failure = nullptr;
+            }
+            catch (const std::exception& ex) {
+                TIMBER_DEBUG("connection attempt failed: {}", ex.what());
+                failure = std::current_exception();
+            }
+
+            a.finished = true;
+            --pending;
+
+            if (connected && !winner) winner = &a - attempts.data();
+            else if (!connected) failed = true;
+
+            timer.disarm();
+        };
+
+        using clock = std::chrono::steady_clock;
+
+        auto expiry = std::optional<clock::time_point>();
+        if (options.timeout) expiry = clock::now() + *options.timeout;
+
+        // Attempts are staggered: the next address is tried when the delay
+        // elapses or as soon as an earlier attempt fails (RFC 8305).
+        auto launch = true;
+        auto expired = false;
+
+        while (!winner) {
+            if (expiry && clock::now() >= *expiry) {
+                expired = true;
+                break;
+            }
+
+            if ((launch || failed) && next < attempts.size()) {
+                launch = false;
+                failed = false;
+                ++pending;
+
+                auto& a = attempts[next++];
+                a.started = true;
+                a.task = start(a);
+
+                continue;
+            }
+
+            if (pending == 0) break;
+
+            auto wait = std::optional<std::chrono::nanoseconds>();
+            if (next < attempts.size()) wait = options.attempt_delay;
+
+            if (expiry) {
+                const auto remaining = *expiry - clock::now();
+                if (!wait || remaining < *wait) wait = remaining;
+            }
+
+            if (wait) timer.set(std::max(*wait, std::chrono::nanoseconds(1)));
+            launch = co_await timer.wait();
+        }
+
+        for (auto& a : attempts) {
+            if (a.started && !a.finished) a.socket.cancel();
+        }
+
+        for (auto& a : attempts) {
+            if (a.started) co_await a.task;
+        }
+
+        if (!winner) {
+            if (expired) {
+                errno = ETIMEDOUT;
+                throw ext::system_error(
+                    fmt::format("Timed out connecting to ({}:{})", host, port)
+                );
             }
+
+            if (failure) std::rethrow_exception(failure);
+
+            errno = error;
+            throw ext::system_error(
+                fmt::format("Failed to connect to ({}:{})", host, port)
+            );
         }
 
-        throw ext::system_error(
-            fmt::format("Failed to connect to ({}:{})", host, port)
+        auto& a = attempts[*winner];
+
+        TIMBER_DEBUG(
+            "{} connected to {}",
+            a.socket,
+            netcore::socket_addr(a.info->ai_addr, a.info->ai_addrlen)
         );
+
+        co_await write_all(a.socket, data.subspan(a.sent));
+        co_return std::move(a.socket);
+    }
+}
+
+namespace netcore {
+    auto connect(
+        std::string_view host,
+        std::string_view port,
+        const connect_options& options
+    ) -> ext::task<socket> {
+        return connect_inet(host, port, {}, options);
     }
 
-    auto connect(std::string_view path) -> ext::task<socket> {
+    auto connect(std::string_view path, const connect_options& options)
+        -> ext::task<socket> {
         auto addr = sockaddr_un();
         addr.sun_family = AF_UNIX;
         path.copy(addr.sun_path, path.size());
 
         auto sock = socket(AF_UNIX, SOCK_STREAM, 0);
 
-        if (co_await sock.connect((sockaddr*) &addr, sizeof(addr))) {
+        if (co_await sock.connect(
+                (sockaddr*) &addr,
+                sizeof(addr),
+                options.timeout
+            )) {
             TIMBER_DEBUG("{} connected to \"{}\"", sock, path);
             co_return sock;
         }
@@ -49,20 +251,50 @@ namespace netcore {
         );
     }
 
-    auto connect(const endpoint& endpoint) -> ext::task<socket> {
+    auto connect(const endpoint& endpoint, const connect_options& options)
+        -> ext::task<socket> {
         return std::visit(
-            [](auto&& arg) {
+            [&options](auto&& arg) {
                 using T = std::decay_t<decltype(arg)>;
 
                 if constexpr (std::is_same_v<T, inet_socket>) {
-                    return connect(arg.host, arg.port);
+                    return connect(arg.host, arg.port, options);
                 }
 
                 if constexpr (std::is_same_v<T, unix_socket>) {
-                    return connect(arg.path.native());
+                    return connect(arg.path.native(), options);
                 }
             },
             endpoint
         );
     }
+
+    auto connect_with_data(
+        std::string_view host,
+        std::string_view port,
+        std::span<const std::byte> data,
+        const connect_options& options
+    ) -> ext::task<socket> {
+        return connect_inet(host, port, data, options);
+    }
+
+    auto connect_with_data(
+        const endpoint& endpoint,
+        std::span<const std::byte> data,
+        const connect_options& options
+    ) -> ext::task<socket> {
+        if (const auto* inet = std::get_if<inet_socket>(&endpoint)) {
+            co_return co_await connect_inet(
+                inet->host,
+                inet->port,
+                data,
+                options
+            );
+        }
+
+        auto sock = co_await connect(endpoint, options);
+        co_await write_all(sock, data);
+
+        co_return sock;
+    }
 }
@@ -0,0 +1,113 @@
+#include <netcore/connection_pool.hpp>
+#include <netcore/timer.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+    struct connection {
+        int id = 0;
+        bool healthy = true;
+    };
+
+    class provider {
+        int next = 0;
+    public:
+        auto checkin(connection& c) -> bool { return c.healthy; }
+
+        auto checkout(connection& c) -> bool { return c.healthy; }
+
+        auto provide() -> ext::task<connection> {
+            co_return connection {.id = ++next};
+        }
+    };
+
+    using pool_type = netcore::connection_pool<provider>;
+}
+
+TEST(ConnectionPool, Reuse) {
+    netcore::run([]() -> ext::task<> {
+        auto pool = pool_type({});
+
+        auto id = 0;
+
+        {
+            const auto item = co_await pool.checkout();
+            id = item->id;
+        }
+
+        EXPECT_EQ(1, pool.available());
+        EXPECT_EQ(id, (co_await pool.checkout())->id);
+
+        const auto& metrics = pool.metrics();
+        EXPECT_EQ(2, metrics.checkouts);
+        EXPECT_EQ(1, metrics.connects);
+        EXPECT_EQ(0, metrics.waits);
+    }());
+}
+
+TEST(ConnectionPool, Warm) {
+    netcore::run([]() -> ext::task<> {
+        auto pool = pool_type({.min_idle = 3});
+        co_await pool.warm();
+
+        EXPECT_EQ(3, pool.available());
+        EXPECT_EQ(3, pool.size());
+
+        const auto item = co_await pool.checkout();
+
+        EXPECT_EQ(2, pool.available());
+        EXPECT_EQ(3, pool.metrics().connects);
+        EXPECT_EQ(0, pool.metrics().waits);
+    }());
+}
+
+TEST(ConnectionPool, MaxSize) {
+    netcore::run([]() -> ext::task<> {
+        auto pool = pool_type({.max_size = 1});
+        auto first = co_await pool.checkout();
+
+        auto waiting = [&]() -> ext::jtask<int> {
+            co_return (co_await pool.checkout())->id;
+        }();
+
+        EXPECT_FALSE(waiting.is_ready());
+
+        const auto id = first->id;
+        first = {};
+
+        EXPECT_EQ(id, co_await waiting);
+        EXPECT_EQ(1, pool.size());
+        EXPECT_EQ(1, pool.metrics().waits);
+    }());
+}
+
+TEST(ConnectionPool, Eviction) {
+    netcore::run([]() -> ext::task<> {
+        auto pool = pool_type({
+            .health_check_interval = 10ms,
+            .idle_timeout = 20ms,
+        });
+
+        {
+            auto healthy = co_await pool.checkout();
+            auto failed = co_await pool.checkout();
+            failed->healthy = false;
+        }
+
+        EXPECT_EQ(1, pool.available());
+        EXPECT_EQ(1, pool.metrics().evictions);
+
+        const auto maintenance = pool.maintain();
+
+        co_await netcore::sleep_for(50ms);
+
+        EXPECT_EQ(0, pool.available());
+        EXPECT_EQ(0, pool.size());
+        EXPECT_EQ(2, pool.metrics().evictions);
+
+        pool.stop();
+        co_await maintenance;
+    }());
+}
@@ -0,0 +1,254 @@
+#include <netcore/datagram_socket.hpp>
+#include <netcore/except.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <ext/except.h>
+#include <netinet/udp.h>
+#include <timber/timber>
+
+namespace {
+    constexpr auto control_size = CMSG_SPACE(sizeof(int));
+    constexpr auto gro_max_size = std::size_t(64 * 1024);
+}
+
+namespace netcore {
+    datagram_socket::datagram_socket(
+        int domain,
+        const datagram_options& options
+    ) :
+        descriptor(::socket(
+            domain,
+            SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+            0
+        )),
+        options(options),
+        storage(std::make_unique_for_overwrite<std::byte[]>(
+            options.batch_size * options.max_size
+        )),
+        control(std::make_unique<char[]>(options.batch_size * control_size)),
+        received(options.batch_size),
+        iov(options.batch_size),
+        headers(options.batch_size) {
+        if (!descriptor.valid()) {
+            throw ext::system_error("failed to create datagram socket");
+        }
+
+        event = runtime::event::create(descriptor, EPOLLIN | EPOLLOUT);
+
+        TIMBER_TRACE("{} created", *this);
+    }
+
+    auto datagram_socket::bind(const netcore::address& address) -> void {
+        if (::bind(descriptor, address->ai_addr, address->ai_addrlen) == -1) {
+            throw ext::system_error(fmt::format(
+                "failed to bind datagram socket to {}",
+                socket_addr(address->ai_addr, address->ai_addrlen)
+            ));
+        }
+
+        TIMBER_DEBUG("{} bound", *this);
+    }
+
+    auto datagram_socket::cancel() noexcept -> void { event->cancel(); }
+
+    auto datagram_socket::connect(const sockaddr* addr, socklen_t len)
+        -> void {
+        if (::connect(descriptor, addr, len) == -1) {
+            throw ext::system_error("failed to connect datagram socket");
+        }
+    }
+
+    auto datagram_socket::enable_gro() -> bool {
+        if (gro) return true;
+
+        int yes = 1;
+
+        if (setsockopt(
+                descriptor,
+                SOL_UDP,
+                UDP_GRO,
+                &yes,
+                sizeof(yes)
+            ) == -1) {
+            if (errno == ENOPROTOOPT || errno == EOPNOTSUPP) return false;
+            throw ext::system_error("failed to enable UDP GRO");
+        }
+
+        gro = true;
+
+        if (options.max_size < gro_max_size) {
+            options.max_size = gro_max_size;
+            storage = std::make_unique_for_overwrite<std::byte[]>(
+                options.batch_size * options.max_size
+            );
+        }
+
+        TIMBER_DEBUG("{} enabled generic receive offload", *this);
+
+        return true;
+    }
+
+    auto datagram_socket::fd() const noexcept -> int { return descriptor; }
+
+    auto datagram_socket::receive() -> ext::task<std::span<const datagram>> {
+        while (true) {
+            for (std::size_t i = 0; i < options.batch_size; ++i) {
+                iov[i] = {
+                    .iov_base = storage.get() + i * options.max_size,
+                    .iov_len = options.max_size};
+
+                auto& header = headers[i].msg_hdr;
+                header = {};
+                header.msg_name = &received[i].peer;
+                header.msg_namelen = sizeof(sockaddr_storage);
+                header.msg_iov = &iov[i];
+                header.msg_iovlen = 1;
+
+                if (gro) {
+                    header.msg_control = control.get() + i * control_size;
+                    header.msg_controllen = control_size;
+                }
+            }
+
+            const auto count = ::recvmmsg(
+                descriptor,
+                headers.data(),
+                options.batch_size,
+                0,
+                nullptr
+            );
+
+            if (count == -1) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    if (!co_await event->in()) throw task_canceled();
+                    continue;
+                }
+
+                throw ext::system_error(
+                    fmt::format("{} failed to receive datagrams", *this)
+                );
+            }
+
+            for (auto i = 0; i < count; ++i) {
+                auto& header = headers[i].msg_hdr;
+                auto& datagram = received[i];
+
+                datagram.data = {
+                    static_cast<const std::byte*>(iov[i].iov_base),
+                    headers[i].msg_len};
+                datagram.peer_len = header.msg_namelen;
+                datagram.segment_size = 0;
+                datagram.truncated = header.msg_flags & MSG_TRUNC;
+
+                if (datagram.truncated) {
+                    TIMBER_DEBUG(
+                        "{} datagram truncated to {:L} bytes",
+                        *this,
+                        options.max_size
+                    );
+                }
+
+                for (auto* cmsg = CMSG_FIRSTHDR(&header); cmsg;
+                     cmsg = CMSG_NXTHDR(&header, cmsg)) {
+                    if (cmsg->cmsg_level == SOL_UDP &&
+                        cmsg->cmsg_type == UDP_GRO) {
+                        int size = 0;
+                        std::memcpy(&size, CMSG_DATA(cmsg), sizeof(size));
+                        datagram.segment_size = size;
+                    }
+                }
+
+                // Without the segment size, coalesced datagrams would be
+                // mistaken for a single one.
+                if (header.msg_flags & MSG_CTRUNC) {
+                    errno = EMSGSIZE;
+                    throw ext::system_error(fmt::format(
+                        "{} datagram control data was truncated",
+                        *this
+                    ));
+                }
+            }
+
+            TIMBER_TRACE(
+                "{} recv {:L} datagram{}",
+                *this,
+                count,
+                count == 1 ? "" : "s"
+            );
+
+            co_return std::span<const datagram>(received.data(), count);
+        }
+    }
+
+    auto datagram_socket::send(std::span<const datagram> datagrams)
+        -> ext::task<> {
+        while (!datagrams.empty()) {
+            const auto batch = std::min(datagrams.size(), options.batch_size);
+
+            for (std::size_t i = 0; i < batch; ++i) {
+                const auto& datagram = datagrams[i];
+
+                iov[i] = {
+                    .iov_base = const_cast<std::byte*>(datagram.data.data()),
+                    .iov_len = datagram.data.size()};
+
+                auto& header = headers[i].msg_hdr;
+                header = {};
+                header.msg_iov = &iov[i];
+                header.msg_iovlen = 1;
+
+                if (datagram.peer_len > 0) {
+                    header.msg_name = const_cast<sockaddr_storage*>(
+                        &datagram.peer
+                    );
+                    header.msg_namelen = datagram.peer_len;
+                }
+
+                if (datagram.segment_size > 0) {
+                    header.msg_control = control.get() + i * control_size;
+                    header.msg_controllen = CMSG_SPACE(sizeof(std::uint16_t));
+
+                    auto* const cmsg = CMSG_FIRSTHDR(&header);
+                    cmsg->cmsg_level = SOL_UDP;
+                    cmsg->cmsg_type = UDP_SEGMENT;
+                    cmsg->cmsg_len = CMSG_LEN(sizeof(std::uint16_t));
+                    std::memcpy(
+                        CMSG_DATA(cmsg),
+                        &datagram.segment_size,
+                        sizeof(std::uint16_t)
+                    );
+                }
+            }
+
+            const auto count = ::sendmmsg(
+                descriptor,
+                headers.data(),
+                batch,
+                MSG_NOSIGNAL
+            );
+
+            if (count == -1) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    if (!co_await event->out()) throw task_canceled();
+                    continue;
+                }
+
+                throw ext::system_error(
+                    fmt::format("{} failed to send datagrams", *this)
+                );
+            }
+
+            TIMBER_TRACE(
+                "{} send {:L} datagram{}",
+                *this,
+                count,
+                count == 1 ? "" : "s"
+            );
+
+            datagrams = datagrams.subspan(count);
+        }
+    }
+
+    auto datagram_socket::valid() const -> bool { return descriptor.valid(); }
+}
@@ -0,0 +1,138 @@
+#include <netcore/datagram_socket.hpp>
+
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+    auto bound(netcore::datagram_socket& socket) -> netcore::datagram {
+        const auto addr = netcore::address("127.0.0.1", "0", SOCK_DGRAM);
+        socket.bind(addr);
+
+        auto result = netcore::datagram();
+        result.peer_len = sizeof(result.peer);
+        getsockname(
+            socket.fd(),
+            reinterpret_cast<sockaddr*>(&result.peer),
+            &result.peer_len
+        );
+
+        return result;
+    }
+
+    auto bytes(std::string_view string) -> std::span<const std::byte> {
+        return std::as_bytes(std::span(string));
+    }
+
+    auto to_string(std::span<const std::byte> bytes) -> std::string {
+        return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+    }
+}
+
+class DatagramSocketTest : public testing::Test {
+protected:
+    netcore::datagram_socket sender;
+    netcore::datagram_socket receiver;
+};
+
+TEST_F(DatagramSocketTest, Batch) {
+    netcore::run([&]() -> ext::task<> {
+        sender = netcore::datagram_socket(AF_INET);
+        receiver = netcore::datagram_socket(AF_INET, {.batch_size = 4});
+
+        auto destination = bound(receiver);
+        const auto messages = std::vector<std::string> {"a", "bb", "ccc"};
+
+        auto outgoing = std::vector<netcore::datagram>();
+        for (const auto& message : messages) {
+            outgoing.push_back(destination);
+            outgoing.back().data = bytes(message);
+        }
+
+        co_await sender.send(outgoing);
+
+        auto incoming = std::vector<std::string>();
+
+        while (incoming.size() < messages.size()) {
+            for (const auto& datagram : co_await receiver.receive()) {
+                incoming.push_back(to_string(datagram.data));
+                EXPECT_EQ(AF_INET, datagram.peer.ss_family);
+            }
+        }
+
+        EXPECT_EQ(messages, incoming);
+    }());
+}
+
+TEST_F(DatagramSocketTest, SegmentationOffload) {
+    netcore::run([&]() -> ext::task<> {
+        sender = netcore::datagram_socket(AF_INET);
+        receiver = netcore::datagram_socket(AF_INET);
+
+        auto datagram = bound(receiver);
+        const auto payload = std::string(3000, 'x');
+
+        datagram.data = bytes(payload);
+        datagram.segment_size = 1000;
+
+        co_await sender.send(std::span(&datagram, 1));
+
+        std::size_t segments = 0;
+
+        while (segments < 3) {
+            for (const auto& received : co_await receiver.receive()) {
+                EXPECT_EQ(1000, received.data.size());
+                ++segments;
+            }
+        }
+    }());
+}
+
+TEST_F(DatagramSocketTest, Truncated) {
+    netcore::run([&]() -> ext::task<> {
+        sender = netcore::datagram_socket(AF_INET);
+        receiver = netcore::datagram_socket(AF_INET, {.max_size = 4});
+
+        auto datagram = bound(receiver);
+        const auto message = std::string("truncated");
+        datagram.data = bytes(message);
+
+        co_await sender.send(std::span(&datagram, 1));
+
+        const auto received = co_await receiver.receive();
+        EXPECT_EQ(1, received.size());
+        EXPECT_TRUE(received.front().truncated);
+        EXPECT_EQ("trun", to_string(received.front().data));
+    }());
+}
+
+TEST_F(DatagramSocketTest, ReceiveOffload) {
+    netcore::run([&]() -> ext::task<> {
+        sender = netcore::datagram_socket(AF_INET);
+        receiver = netcore::datagram_socket(AF_INET);
+
+        if (!receiver.enable_gro()) co_return;
+
+        auto datagram = bound(receiver);
+        const auto payload = std::string(6000, 'x');
+
+        datagram.data = bytes(payload);
+        datagram.segment_size = 1500;
+
+        co_await sender.send(std::span(&datagram, 1));
+
+        // Segments may be coalesced into datagrams larger than the default
+        // buffer size.
+        std::size_t total = 0;
+        auto truncated = false;
+
+        while (total < payload.size() && !truncated) {
+            for (const auto& received : co_await receiver.receive()) {
+                truncated = truncated || received.truncated;
+                total += received.data.size();
+            }
+        }
+
+        EXPECT_FALSE(truncated);
+        EXPECT_EQ(payload.size(), total);
+    }());
+}
@@ -0,0 +1,80 @@
+#include <netcore/deadline.hpp>
+
+namespace netcore {
+    deadline::~deadline() {
+        unschedule();
+        if (suspended) --owner->awaiters;
+    }
+
+    auto deadline::disarm() -> void {
+        unschedule();
+
+        expired = false;
+        woken = true;
+
+        wake();
+    }
+
+    auto deadline::expire() -> void {
+        scheduled = false;
+        expired = true;
+
+        wake();
+    }
+
+    auto deadline::set(std::chrono::nanoseconds duration) -> void {
+        unschedule();
+
+        owner = &runtime::current();
+        entry = owner->deadlines.emplace(
+            std::chrono::steady_clock::now() + duration,
+            this
+        );
+        scheduled = true;
+        expired = false;
+    }
+
+    auto deadline::unschedule() noexcept -> void {
+        if (!scheduled) return;
+
+        owner->deadlines.erase(entry);
+        scheduled = false;
+    }
+
+    auto deadline::wait() noexcept -> awaitable { return awaitable(*this); }
+
+    auto deadline::waiting() const noexcept -> bool { return suspended; }
+
+    auto deadline::wake() -> void {
+        if (!suspended) return;
+
+        suspended = false;
+        --owner->awaiters;
+
+        awaiter.next = nullptr;
+        owner->enqueue(awaiter);
+    }
+
+    deadline::awaitable::awaitable(deadline& d) noexcept : d(d) {}
+
+    auto deadline::awaitable::await_ready() const noexcept -> bool {
+        return d.expired || d.woken;
+    }
+
+    auto deadline::awaitable::await_suspend(std::coroutine_handle<> coroutine)
+        -> void {
+        d.owner = &runtime::current();
+        d.awaiter.coroutine = coroutine;
+        d.suspended = true;
+        ++d.owner->awaiters;
+    }
+
+    auto deadline::awaitable::await_resume() noexcept -> bool {
+        const auto result = d.expired;
+
+        d.expired = false;
+        d.woken = false;
+
+        return result;
+    }
+}
@@ -0,0 +1,85 @@
+#include <netcore/deadline.hpp>
+#include <netcore/runtime.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+    auto now() { return std::chrono::steady_clock::now(); }
+}
+
+TEST(Deadline, Expire) {
+    netcore::run([]() -> ext::task<> {
+        constexpr auto time = 20ms;
+
+        auto deadline = netcore::deadline();
+        deadline.set(time);
+
+        const auto start = now();
+        const auto expired = co_await deadline.wait();
+        const auto elapsed = now() - start;
+
+        EXPECT_TRUE(expired);
+        EXPECT_GE(elapsed, time);
+    }());
+}
+
+TEST(Deadline, Disarm) {
+    netcore::run([]() -> ext::task<> {
+        constexpr auto time = 30s;
+
+        auto deadline = netcore::deadline();
+        auto expired = true;
+
+        const auto wait = [&]() -> ext::jtask<> {
+            expired = co_await deadline.wait();
+        };
+
+        deadline.set(time);
+
+        auto waiter = wait();
+        EXPECT_TRUE(deadline.waiting());
+
+        const auto start = now();
+        deadline.disarm();
+        co_await waiter;
+
+        EXPECT_LT(now() - start, time);
+        EXPECT_FALSE(expired);
+        EXPECT_FALSE(deadline.waiting());
+    }());
+}
+
+TEST(Deadline, DisarmBeforeWait) {
+    netcore::run([]() -> ext::task<> {
+        auto deadline = netcore::deadline();
+        deadline.set(30s);
+        deadline.disarm();
+
+        EXPECT_FALSE(co_await deadline.wait());
+    }());
+}
+
+TEST(Deadline, Order) {
+    netcore::run([]() -> ext::task<> {
+        auto first = netcore::deadline();
+        auto second = netcore::deadline();
+        auto order = std::vector<int>();
+
+        const auto wait = [&](netcore::deadline& d, int n) -> ext::jtask<> {
+            if (co_await d.wait()) order.push_back(n);
+        };
+
+        second.set(20ms);
+        first.set(10ms);
+
+        auto a = wait(second, 2);
+        auto b = wait(first, 1);
+
+        co_await a;
+        co_await b;
+
+        EXPECT_EQ((std::vector<int> {1, 2}), order);
+    }());
+}
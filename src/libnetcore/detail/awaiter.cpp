@@ -72,6 +72,25 @@ namespace netcore::detail {
         return a;
     }
 
+    auto awaiter_queue::remove(awaiter& a) noexcept -> void {
+        awaiter* previous = nullptr;
+
+        for (auto* current = head; current; current = current->next) {
+            if (current != &a) {
+                previous = current;
+                continue;
+            }
+
+            if (previous) previous->next = a.next;
+            else head = a.next;
+
+            if (tail == &a) tail = previous;
+            a.next = nullptr;
+
+            return;
+        }
+    }
+
     auto awaiter_queue::resume() -> void {
         // Make a local copy of the awaiter list, and create a new list
         // as resumed coroutines could add more awaiters.
@@ -1,12 +1,158 @@
 #include <netcore/file.hpp>
 
+#include <cstring>
 #include <ext/except.h>
-#include <fcntl.h>
+#include <sys/uio.h>
 #include <timber/timber>
 
+namespace {
+    // Attempts a read or write that is served entirely from the page cache,
+    // without blocking the calling thread on disk I/O.
+    auto nowait(bool write, int fd, void* data, std::size_t len, off_t offset)
+        -> long {
+        const auto iov = iovec {.iov_base = data, .iov_len = len};
+
+        const auto bytes = write ? ::pwritev2(fd, &iov, 1, offset, RWF_NOWAIT)
+                                 : ::preadv2(fd, &iov, 1, offset, RWF_NOWAIT);
+
+        if (bytes == -1) {
+            if (errno == EAGAIN || errno == EOPNOTSUPP) return -1;
+
+            throw ext::system_error(
+                write ? "failed to write to file" : "failed to read from file"
+            );
+        }
+
+        return bytes;
+    }
+}
+
 namespace netcore {
-    auto open(const std::filesystem::path& path, int flags) -> fd {
-        const auto result = ::open(path.c_str(), flags);
+    file::file(
+        awaitable_thread_pool& pool,
+        netcore::fd&& descriptor,
+        const file_options& options
+    ) :
+        descriptor(std::forward<netcore::fd>(descriptor)),
+        pool(&pool),
+        options(options) {
+        if (const auto error =
+                ::posix_fadvise(this->descriptor, 0, 0, options.advice)) {
+            TIMBER_DEBUG(
+                "file ({}) advice not applied: {}",
+                int(this->descriptor),
+                std::strerror(error)
+            );
+        }
+    }
+
+    file::file(
+        awaitable_thread_pool& pool,
+        const std::filesystem::path& path,
+        int flags,
+        const file_options& options
+    ) :
+        file(pool, netcore::open(path, flags | O_CLOEXEC), options) {}
+
+    auto file::advance(long bytes) noexcept -> long {
+        position += bytes;
+
+        TIMBER_TRACE(
+            "file ({}) transferred {:L} byte{}",
+            fd(),
+            bytes,
+            bytes == 1 ? "" : "s"
+        );
+
+        return bytes;
+    }
+
+    auto file::await_write() -> ext::task<> { co_return; }
+
+    auto file::fd() const noexcept -> int { return descriptor; }
+
+    auto file::read(void* dest, std::size_t len) -> ext::task<std::size_t> {
+        const auto cached = try_read(dest, len);
+        if (cached >= 0) co_return cached;
+
+        const auto fd = this->fd();
+        const auto offset = position;
+        const auto read_ahead = off_t(options.read_ahead);
+
+        // Keep the kernel's read-ahead window at least half a window in
+        // front of the reader, so later reads hit the page cache.
+        auto advise = std::optional<off_t>();
+        if (read_ahead > 0 && offset + read_ahead / 2 >= advised) {
+            advise = std::max(advised, offset);
+            advised = offset + read_ahead;
+        }
+
+        const auto bytes = co_await pool->await([=]() -> long {
+            const auto result = ::pread(fd, dest, len, offset);
+
+            if (result == -1) {
+                throw ext::system_error("failed to read from file");
+            }
+
+            if (advise) {
+                ::posix_fadvise(
+                    fd,
+                    *advise,
+                    offset + read_ahead - *advise,
+                    POSIX_FADV_WILLNEED
+                );
+            }
+
+            return result;
+        });
+
+        co_return advance(bytes);
+    }
+
+    auto file::seek(off_t offset) noexcept -> void {
+        position = offset;
+        advised = offset;
+    }
+
+    auto file::tell() const noexcept -> off_t { return position; }
+
+    auto file::try_read(void* dest, std::size_t len) -> long {
+        const auto bytes = nowait(false, fd(), dest, len, position);
+        return bytes == -1 ? bytes : advance(bytes);
+    }
+
+    auto file::try_write(const void* src, std::size_t len) -> long {
+        const auto bytes =
+            nowait(true, fd(), const_cast<void*>(src), len, position);
+        return bytes == -1 ? bytes : advance(bytes);
+    }
+
+    auto file::valid() const -> bool { return descriptor.valid(); }
+
+    auto file::write(const void* src, std::size_t len)
+        -> ext::task<std::size_t> {
+        const auto cached = try_write(src, len);
+        if (cached >= 0) co_return cached;
+
+        const auto fd = this->fd();
+        const auto offset = position;
+
+        const auto bytes = co_await pool->await([=]() -> long {
+            const auto result = ::pwrite(fd, src, len, offset);
+
+            if (result == -1) {
+                throw ext::system_error("failed to write to file");
+            }
+
+            return result;
+        });
+
+        co_return advance(bytes);
+    }
+
+    auto open(const std::filesystem::path& path, int flags, mode_t mode)
+        -> fd {
+        const auto result = ::open(path.c_str(), flags, mode);
 
         if (result == -1) {
             throw ext::system_error(
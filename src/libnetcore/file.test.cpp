@@ -0,0 +1,54 @@
+#include <netcore/buffered_reader.hpp>
+#include <netcore/buffered_writer.hpp>
+#include <netcore/file.hpp>
+
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class FileTest : public testing::Test {
+protected:
+    fs::path path;
+
+    auto SetUp() -> void override {
+        path = fs::temp_directory_path() / "netcore.file.test";
+    }
+
+    auto TearDown() -> void override { fs::remove(path); }
+};
+
+TEST_F(FileTest, WriteRead) {
+    auto data = std::vector<std::byte>(1024 * 1024);
+    for (std::size_t i = 0; i < data.size(); ++i) data[i] = std::byte(i);
+
+    netcore::run([&]() -> ext::task<> {
+        auto pool = netcore::awaitable_thread_pool("file", 1);
+
+        {
+            auto file = netcore::file(
+                pool,
+                path,
+                O_WRONLY | O_CREAT | O_TRUNC
+            );
+            auto writer = netcore::buffered_writer(file, 4096);
+
+            for (std::size_t i = 0; i < data.size(); i += 1000) {
+                const auto len = std::min<std::size_t>(1000, data.size() - i);
+                co_await writer.write(data.data() + i, len);
+            }
+
+            co_await writer.flush();
+            EXPECT_EQ(data.size(), file.tell());
+        }
+
+        auto file = netcore::file(pool, path, O_RDONLY);
+        auto reader = netcore::buffered_reader(file, 4096);
+        auto result = std::vector<std::byte>(data.size());
+
+        co_await reader.read(result.data(), result.size());
+
+        EXPECT_EQ(data, result);
+        EXPECT_THROW(co_await reader.read(result.data(), 1), netcore::eof);
+    }());
+}
@@ -0,0 +1,87 @@
+#include <netcore/file.hpp>
+#include <netcore/file_cache.hpp>
+
+#include <ext/except.h>
+#include <fcntl.h>
+#include <timber/timber>
+
+namespace {
+    auto modified(
+        const struct stat& cached,
+        const struct stat& current
+    ) noexcept -> bool {
+        return cached.st_dev != current.st_dev ||
+               cached.st_ino != current.st_ino ||
+               cached.st_size != current.st_size ||
+               cached.st_mtim.tv_sec != current.st_mtim.tv_sec ||
+               cached.st_mtim.tv_nsec != current.st_mtim.tv_nsec;
+    }
+}
+
+namespace netcore {
+    auto file_cache::current() -> file_cache& {
+        thread_local auto instance = file_cache();
+        return instance;
+    }
+
+    file_cache::file_cache(std::size_t max_size) : max_size(max_size) {}
+
+    auto file_cache::clear() noexcept -> void {
+        index.clear();
+        entries.clear();
+    }
+
+    auto file_cache::erase(list::iterator it) -> void {
+        index.erase(it->first);
+        entries.erase(it);
+    }
+
+    auto file_cache::open(const std::filesystem::path& path)
+        -> std::shared_ptr<const entry> {
+        struct stat status = {};
+
+        if (::stat(path.c_str(), &status) == -1) {
+            const auto error = errno;
+
+            // The file is gone; don't keep its descriptor alive.
+            if (const auto it = index.find(path.native()); it != index.end()) {
+                erase(it->second);
+            }
+
+            errno = error;
+            throw ext::system_error(
+                fmt::format(R"(could not stat file: "{}")", path.native())
+            );
+        }
+
+        if (const auto it = index.find(path.native()); it != index.end()) {
+            if (!modified(it->second->second->status, status)) {
+                entries.splice(entries.begin(), entries, it->second);
+                return entries.front().second;
+            }
+
+            TIMBER_DEBUG(R"(file modified: "{}")", path.native());
+            erase(it->second);
+        }
+
+        auto result = std::make_shared<entry>();
+        result->descriptor = netcore::open(path, O_RDONLY | O_CLOEXEC);
+
+        if (::fstat(result->descriptor, &result->status) == -1) {
+            throw ext::system_error(
+                fmt::format(R"(could not stat file: "{}")", path.native())
+            );
+        }
+
+        entries.emplace_front(path.native(), result);
+        index.emplace(path.native(), entries.begin());
+
+        while (entries.size() > max_size) erase(std::prev(entries.end()));
+
+        return result;
+    }
+
+    auto file_cache::size() const noexcept -> std::size_t {
+        return entries.size();
+    }
+}
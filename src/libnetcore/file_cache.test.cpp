@@ -0,0 +1,84 @@
+#include <netcore/file_cache.hpp>
+
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+class FileCacheTest : public testing::Test {
+protected:
+    fs::path directory;
+
+    auto SetUp() -> void override {
+        directory = fs::temp_directory_path() / "netcore.file_cache.test";
+        fs::create_directories(directory);
+    }
+
+    auto TearDown() -> void override { fs::remove_all(directory); }
+
+    auto write(std::string_view name, std::string_view contents) -> fs::path {
+        const auto path = directory / name;
+        std::ofstream(path) << contents;
+        return path;
+    }
+};
+
+TEST_F(FileCacheTest, Hit) {
+    const auto path = write("a", "hello");
+    auto cache = netcore::file_cache();
+
+    const auto first = cache.open(path);
+    const auto second = cache.open(path);
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(5, first->status.st_size);
+    EXPECT_EQ(1, cache.size());
+}
+
+TEST_F(FileCacheTest, Modified) {
+    const auto path = write("a", "hello");
+    auto cache = netcore::file_cache();
+
+    const auto first = cache.open(path);
+    write("a", "hello world");
+    const auto second = cache.open(path);
+
+    EXPECT_NE(first, second);
+    EXPECT_EQ(11, second->status.st_size);
+    EXPECT_EQ(1, cache.size());
+}
+
+TEST_F(FileCacheTest, Eviction) {
+    const auto a = write("a", "a");
+    const auto b = write("b", "b");
+    const auto c = write("c", "c");
+    auto cache = netcore::file_cache(2);
+
+    const auto first = cache.open(a);
+    cache.open(b);
+    cache.open(a);
+    cache.open(c);
+
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(first, cache.open(a));
+    EXPECT_TRUE(first->descriptor.valid());
+}
+
+TEST_F(FileCacheTest, Missing) {
+    auto cache = netcore::file_cache();
+
+    EXPECT_THROW(cache.open(directory / "missing"), std::system_error);
+    EXPECT_EQ(0, cache.size());
+}
+
+TEST_F(FileCacheTest, Removed) {
+    const auto path = write("a", "hello");
+    auto cache = netcore::file_cache();
+
+    const auto weak = std::weak_ptr(cache.open(path));
+    fs::remove(path);
+
+    EXPECT_THROW(cache.open(path), std::system_error);
+    EXPECT_EQ(0, cache.size());
+    EXPECT_TRUE(weak.expired());
+}
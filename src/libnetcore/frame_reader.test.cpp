@@ -0,0 +1,111 @@
+#include <netcore/buffered_reader.hpp>
+#include <netcore/frame_reader.hpp>
+#include <netcore/runtime.hpp>
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+    class memory_source {
+        std::vector<std::byte> data;
+        std::size_t position = 0;
+        std::size_t chunk_size;
+    public:
+        memory_source(std::size_t chunk_size) : chunk_size(chunk_size) {}
+
+        auto frame(
+            std::string_view payload,
+            std::size_t prefix_size = 4,
+            std::endian byte_order = std::endian::big
+        ) -> void {
+            for (std::size_t i = 0; i < prefix_size; ++i) {
+                const auto shift = byte_order == std::endian::big
+                                       ? (prefix_size - i - 1) * 8
+                                       : i * 8;
+
+                data.push_back(static_cast<std::byte>(payload.size() >> shift)
+                );
+            }
+
+            for (const auto c : payload) data.push_back(std::byte(c));
+        }
+
+        auto read(void* dest, std::size_t len) -> ext::task<std::size_t> {
+            co_return try_read(dest, len);
+        }
+
+        auto try_read(void* dest, std::size_t len) -> long {
+            len = std::min({len, chunk_size, data.size() - position});
+
+            std::memcpy(dest, data.data() + position, len);
+            position += len;
+
+            return len;
+        }
+    };
+
+    auto to_string(std::span<const std::byte> bytes) -> std::string {
+        return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+    }
+}
+
+TEST(FrameReader, ResidentFrames) {
+    netcore::run([]() -> ext::task<> {
+        auto source = memory_source(3);
+        source.frame("hello");
+        source.frame("");
+        source.frame("world");
+
+        auto reader = netcore::buffered_reader(source, 16);
+        auto frames = netcore::frame_reader(reader);
+
+        EXPECT_EQ("hello", to_string(co_await frames.read()));
+        EXPECT_EQ("", to_string(co_await frames.read()));
+        EXPECT_EQ("world", to_string(co_await frames.read()));
+        EXPECT_THROW(co_await frames.read(), netcore::eof);
+    }());
+}
+
+TEST(FrameReader, LargeFrame) {
+    netcore::run([]() -> ext::task<> {
+        const auto payload = std::string(100, 'a');
+
+        auto source = memory_source(64);
+        source.frame(payload);
+        source.frame("small");
+
+        auto reader = netcore::buffered_reader(source, 16);
+        auto frames = netcore::frame_reader(reader);
+
+        EXPECT_EQ(payload, to_string(co_await frames.read()));
+        EXPECT_EQ("small", to_string(co_await frames.read()));
+    }());
+}
+
+TEST(FrameReader, PrefixOptions) {
+    netcore::run([]() -> ext::task<> {
+        auto source = memory_source(8);
+        source.frame("little endian", 2, std::endian::little);
+
+        auto reader = netcore::buffered_reader(source, 32);
+        auto frames = netcore::frame_reader(
+            reader,
+            {.prefix_size = 2, .byte_order = std::endian::little}
+        );
+
+        EXPECT_EQ("little endian", to_string(co_await frames.read()));
+    }());
+}
+
+TEST(FrameReader, MaxSize) {
+    netcore::run([]() -> ext::task<> {
+        auto source = memory_source(8);
+        source.frame("too long");
+
+        auto reader = netcore::buffered_reader(source, 32);
+        auto frames = netcore::frame_reader(reader, {.max_size = 4});
+
+        EXPECT_THROW(co_await frames.read(), std::runtime_error);
+    }());
+}
@@ -0,0 +1,187 @@
+#include <netcore/client.hpp>
+#include <netcore/hedge.hpp>
+#include <netcore/server_socket.hpp>
+#include <netcore/timer.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+    struct connection {
+        netcore::buffered_socket socket;
+
+        connection(netcore::buffered_socket&& socket) :
+            socket(std::move(socket)) {}
+
+        auto cancel() -> void { socket.cancel(); }
+
+        auto connected() -> bool { return true; }
+
+        auto failed() -> bool { return false; }
+    };
+
+    using client_type = netcore::client<connection>;
+
+    // The first call waits for a response that never arrives.
+    auto stall_first(int& calls, connection& c) -> ext::task<int> {
+        const auto call = calls++;
+
+        if (call == 0) {
+            char byte;
+            co_await c.socket.read(&byte, sizeof(byte));
+        }
+
+        co_return call;
+    }
+
+    // The first call is busy with something other than its socket.
+    auto sleep_first(int& calls, connection&) -> ext::task<int> {
+        const auto call = calls++;
+
+        if (call == 0) co_await netcore::sleep_for(500ms);
+
+        co_return call;
+    }
+
+    auto slow(connection&) -> ext::task<int> {
+        co_await netcore::sleep_for(20ms);
+        co_return 1;
+    }
+
+    auto fast(connection&) -> ext::task<int> { co_return 1; }
+
+    auto listen() -> netcore::server_socket {
+        const auto addr = netcore::address("127.0.0.1", "0");
+
+        auto socket = netcore::server_socket(addr->ai_family, SOCK_STREAM, 0);
+        socket.bind(addr);
+        socket.listen(8);
+
+        return socket;
+    }
+
+    auto local_endpoint(const netcore::server_socket& socket) -> std::string {
+        auto bound = sockaddr_in();
+        auto len = socklen_t(sizeof(bound));
+        getsockname(socket.fd(), reinterpret_cast<sockaddr*>(&bound), &len);
+
+        return fmt::format("127.0.0.1:{}", ntohs(bound.sin_port));
+    }
+}
+
+class HedgeTest : public testing::Test {
+protected:
+    netcore::server_socket listener = listen();
+    std::string endpoint = local_endpoint(listener);
+};
+
+TEST_F(HedgeTest, BackupWins) {
+    netcore::run([&]() -> ext::task<> {
+        auto client = client_type(endpoint, 1024);
+        auto hedger = netcore::hedger(
+            client,
+            {.initial_delay = 10ms, .budget = 1}
+        );
+
+        auto calls = 0;
+        const auto result = co_await hedger.request(
+            [&calls](connection& c) { return stall_first(calls, c); }
+        );
+
+        EXPECT_EQ(1, result);
+
+        const auto& metrics = hedger.metrics();
+        EXPECT_EQ(1, metrics.requests);
+        EXPECT_EQ(1, metrics.hedges);
+        EXPECT_EQ(1, metrics.wins);
+
+        // The cancelled connection is closed instead of being reused.
+        EXPECT_EQ(2, client.metrics().connects);
+        EXPECT_EQ(1, client.metrics().evictions);
+    }());
+}
+
+TEST_F(HedgeTest, BusyLoser) {
+    netcore::run([&]() -> ext::task<> {
+        auto client = client_type(endpoint, 1024);
+        auto hedger = netcore::hedger(
+            client,
+            {.initial_delay = 10ms, .budget = 1}
+        );
+
+        const auto start = std::chrono::steady_clock::now();
+
+        auto calls = 0;
+        const auto result = co_await hedger.request(
+            [&calls](connection& c) { return sleep_first(calls, c); }
+        );
+
+        // The request does not wait for the primary to finish.
+        EXPECT_EQ(1, result);
+        EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);
+
+        EXPECT_EQ(1, hedger.metrics().wins);
+        EXPECT_EQ(2, client.metrics().connects);
+        EXPECT_EQ(1, client.metrics().evictions);
+    }());
+}
+
+TEST_F(HedgeTest, PrimaryWins) {
+    netcore::run([&]() -> ext::task<> {
+        constexpr auto delay = 500ms;
+
+        auto client = client_type(endpoint, 1024);
+        auto hedger = netcore::hedger(
+            client,
+            {.initial_delay = delay, .budget = 1}
+        );
+
+        const auto start = std::chrono::steady_clock::now();
+
+        EXPECT_EQ(1, co_await hedger.request(slow));
+        EXPECT_LT(std::chrono::steady_clock::now() - start, delay);
+
+        const auto& metrics = hedger.metrics();
+        EXPECT_EQ(1, metrics.requests);
+        EXPECT_EQ(0, metrics.hedges);
+        EXPECT_EQ(0, metrics.throttled);
+        EXPECT_EQ(1, client.metrics().connects);
+        EXPECT_EQ(0, client.metrics().evictions);
+    }());
+}
+
+TEST_F(HedgeTest, Budget) {
+    netcore::run([&]() -> ext::task<> {
+        auto client = client_type(endpoint, 1024);
+        auto hedger = netcore::hedger(
+            client,
+            {.initial_delay = 1ms, .budget = 0}
+        );
+
+        EXPECT_EQ(1, co_await hedger.request(slow));
+
+        const auto& metrics = hedger.metrics();
+        EXPECT_EQ(0, metrics.hedges);
+        EXPECT_EQ(1, metrics.throttled);
+        EXPECT_EQ(1, client.metrics().connects);
+    }());
+}
+
+TEST_F(HedgeTest, Percentile) {
+    netcore::run([&]() -> ext::task<> {
+        auto client = client_type(endpoint, 1024);
+        auto hedger = netcore::hedger(
+            client,
+            {.initial_delay = 50ms, .min_delay = 2ms, .min_samples = 10}
+        );
+
+        EXPECT_EQ(50ms, hedger.delay());
+
+        for (auto i = 0; i < 10; ++i) co_await hedger.request(fast);
+
+        EXPECT_EQ(2ms, hedger.delay());
+        EXPECT_EQ(0, hedger.metrics().hedges);
+        EXPECT_EQ(1, client.metrics().connects);
+    }());
+}
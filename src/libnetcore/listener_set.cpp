@@ -0,0 +1,211 @@
+#include <netcore/address.hpp>
+#include <netcore/listener_set.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <ext/except.h>
+#include <optional>
+#include <sys/socket.h>
+#include <timber/timber>
+#include <unistd.h>
+
+namespace {
+    constexpr auto offer_message = std::byte('L');
+    constexpr auto ack_message = std::byte('A');
+
+    // The first descriptor passed by socket activation (SD_LISTEN_FDS_START).
+    constexpr auto listen_fds_start = 3;
+
+    auto parse_int(const char* string) -> std::optional<long> {
+        if (!string) return std::nullopt;
+
+        const auto* const end = string + std::strlen(string);
+        auto result = 0L;
+
+        const auto [ptr, ec] = std::from_chars(string, end, result);
+        if (ec != std::errc() || ptr != end) return std::nullopt;
+
+        return result;
+    }
+
+    auto listening(int fd) -> bool {
+        int value = 0;
+        auto len = socklen_t(sizeof(value));
+
+        return getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &value, &len) == 0 &&
+               value != 0;
+    }
+
+    auto bound_address(int fd) -> netcore::peer_address {
+        auto result = netcore::peer_address();
+        auto len = result.capacity();
+
+        if (getsockname(fd, result.data(), &len) == -1) {
+            throw ext::system_error("Failed to read server socket address");
+        }
+
+        result.resize(len);
+        return result;
+    }
+
+    auto matches(int fd, const netcore::inet_socket& inet) -> bool {
+        const auto addr = netcore::address(inet.host, inet.port);
+        const auto bound = bound_address(fd);
+
+        for (const auto* res = &*addr; res; res = res->ai_next) {
+            if (netcore::peer_address(res->ai_addr, res->ai_addrlen) == bound) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    auto matches(int fd, const netcore::unix_socket& unix_socket) -> bool {
+        const auto bound = bound_address(fd);
+        const auto path = bound.path();
+
+        return !path.empty() && path == unix_socket.path.native();
+    }
+}
+
+namespace netcore {
+    auto listener_set::acknowledge(socket& control) -> ext::task<> {
+        co_await control.write(&ack_message, sizeof(ack_message));
+    }
+
+    auto listener_set::from_environment() -> listener_set {
+        auto result = listener_set();
+
+        const auto pid = parse_int(std::getenv("LISTEN_PID"));
+        const auto count = parse_int(std::getenv("LISTEN_FDS"));
+        const auto* names = std::getenv("LISTEN_FDNAMES");
+
+        // The variables may have been meant for a parent process.
+        if (!pid || *pid != getpid() || !count) return result;
+
+        auto remaining = std::string_view(names ? names : "");
+
+        for (auto i = 0L; i < *count; ++i) {
+            const auto fd = static_cast<int>(listen_fds_start + i);
+
+            const auto separator = remaining.find(':');
+            const auto name = remaining.substr(0, separator);
+            remaining = separator == std::string_view::npos
+                            ? std::string_view()
+                            : remaining.substr(separator + 1);
+
+            if (!listening(fd)) {
+                TIMBER_WARNING(
+                    "Ignoring activated descriptor ({}): not listening",
+                    fd
+                );
+                continue;
+            }
+
+            result.add(fd, name);
+        }
+
+        unsetenv("LISTEN_PID");
+        unsetenv("LISTEN_FDS");
+        unsetenv("LISTEN_FDNAMES");
+
+        TIMBER_INFO(
+            "Activated with {:L} listener{}",
+            result.size(),
+            result.size() == 1 ? "" : "s"
+        );
+
+        return result;
+    }
+
+    auto listener_set::offer(socket& control, std::span<const int> fds)
+        -> ext::task<bool> {
+        co_await control.send_fds(fds, &offer_message, sizeof(offer_message));
+
+        TIMBER_INFO(
+            "Offered {:L} listener{} for handoff",
+            fds.size(),
+            fds.size() == 1 ? "" : "s"
+        );
+
+        auto reply = std::byte();
+        if (co_await control.read(&reply, sizeof(reply)) == 0) co_return false;
+
+        co_return reply == ack_message;
+    }
+
+    auto listener_set::receive(socket& control) -> ext::task<listener_set> {
+        auto fds = std::vector<netcore::fd>();
+        auto message = std::byte();
+
+        const auto bytes =
+            co_await control.receive_fds(&message, sizeof(message), fds);
+
+        if (bytes == 0 || message != offer_message) {
+            throw std::runtime_error("Invalid listener handoff message");
+        }
+
+        auto result = listener_set();
+        for (auto& fd : fds) result.add(fd.release());
+
+        TIMBER_INFO(
+            "Received {:L} listener{}",
+            result.size(),
+            result.size() == 1 ? "" : "s"
+        );
+
+        co_return result;
+    }
+
+    auto listener_set::add(int fd, std::string_view name) -> void {
+        listeners.push_back({netcore::fd(fd), std::string(name)});
+    }
+
+    auto listener_set::empty() const noexcept -> bool {
+        return listeners.empty();
+    }
+
+    auto listener_set::size() const noexcept -> std::size_t {
+        return listeners.size();
+    }
+
+    auto listener_set::take(const endpoint& endpoint) -> netcore::fd {
+        const auto it = std::find_if(
+            listeners.begin(),
+            listeners.end(),
+            [&endpoint](const listener& l) {
+                return std::visit(
+                    [&l](const auto& arg) {
+                        return matches(l.descriptor, arg);
+                    },
+                    endpoint
+                );
+            }
+        );
+
+        if (it == listeners.end()) return {};
+
+        auto result = std::move(it->descriptor);
+        listeners.erase(it);
+
+        return result;
+    }
+
+    auto listener_set::take(std::string_view name) -> netcore::fd {
+        const auto it = std::find_if(
+            listeners.begin(),
+            listeners.end(),
+            [name](const listener& l) { return l.name == name; }
+        );
+
+        if (it == listeners.end()) return {};
+
+        auto result = std::move(it->descriptor);
+        listeners.erase(it);
+
+        return result;
+    }
+}
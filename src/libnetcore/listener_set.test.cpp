@@ -0,0 +1,160 @@
+#include <netcore/listener_set.hpp>
+#include <netcore/server_socket.hpp>
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <timber/timber>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+    auto listen_inet() -> netcore::server_socket {
+        const auto addr = netcore::address("127.0.0.1", "0");
+
+        auto socket = netcore::server_socket(addr->ai_family, SOCK_STREAM, 0);
+        socket.bind(addr);
+        socket.listen(8);
+
+        return socket;
+    }
+
+    auto listen_unix(const fs::path& path) -> netcore::server_socket {
+        auto socket = netcore::server_socket(AF_UNIX, SOCK_STREAM, 0);
+        socket.bind(path);
+        socket.listen(8);
+
+        return socket;
+    }
+
+    auto port(int fd) -> std::string {
+        auto bound = sockaddr_in();
+        auto len = socklen_t(sizeof(bound));
+        getsockname(fd, reinterpret_cast<sockaddr*>(&bound), &len);
+
+        return std::to_string(ntohs(bound.sin_port));
+    }
+
+    // Runs in a child process so that the descriptors can be placed where
+    // socket activation puts them. Returns the number of failed checks.
+    auto activate(const fs::path& path) -> int {
+        const auto inet = listen_inet();
+        const auto unix = listen_unix(path);
+        const auto inactive = netcore::fd(socket(AF_INET, SOCK_STREAM, 0));
+        const auto expected = port(inet.fd());
+
+        // The descriptors replaced below belong to the test runner, which
+        // logs to one of them.
+        timber::log_handler = [](const timber::log&) noexcept {};
+
+        // Move the sockets out of the way before placing them.
+        const int fds[] = {
+            fcntl(inet.fd(), F_DUPFD, 64),
+            fcntl(inactive, F_DUPFD, 64),
+            fcntl(unix.fd(), F_DUPFD, 64)};
+
+        for (auto i = 0; i < 3; ++i) dup2(fds[i], 3 + i);
+
+        const auto pid = std::to_string(getpid());
+        setenv("LISTEN_PID", pid.c_str(), 1);
+        setenv("LISTEN_FDS", "3", 1);
+        setenv("LISTEN_FDNAMES", "http:inactive:control", 1);
+
+        auto listeners = netcore::listener_set::from_environment();
+        auto failures = 0;
+
+        if (listeners.size() != 2) ++failures;
+        if (std::getenv("LISTEN_PID") || std::getenv("LISTEN_FDS") ||
+            std::getenv("LISTEN_FDNAMES")) {
+            ++failures;
+        }
+
+        if (listeners.take("inactive").valid()) ++failures;
+
+        const auto http = listeners.take("http");
+        if (!http.valid() || port(http) != expected) ++failures;
+
+        if (!listeners.take("control").valid()) ++failures;
+        if (!listeners.empty()) ++failures;
+
+        return failures;
+    }
+}
+
+class ListenerSetTest : public testing::Test {
+protected:
+    const fs::path path = fs::temp_directory_path() / "netcore.listener.sock";
+
+    auto TearDown() -> void override { fs::remove(path); }
+};
+
+TEST_F(ListenerSetTest, TakeByEndpoint) {
+    const auto inet = listen_inet();
+    const auto unix = listen_unix(path);
+
+    auto listeners = netcore::listener_set();
+    listeners.add(dup(inet.fd()));
+    listeners.add(dup(unix.fd()));
+
+    EXPECT_EQ(2, listeners.size());
+
+    const auto other = listen_inet();
+    const auto unmatched = listeners.take(netcore::inet_socket {
+        .host = "127.0.0.1",
+        .port = port(other.fd())});
+    EXPECT_FALSE(unmatched.valid());
+
+    const auto taken = listeners.take(netcore::inet_socket {
+        .host = "127.0.0.1",
+        .port = port(inet.fd())});
+    EXPECT_TRUE(taken.valid());
+    EXPECT_EQ(port(inet.fd()), port(taken));
+
+    EXPECT_TRUE(listeners.take(netcore::unix_socket {.path = path}).valid());
+    EXPECT_TRUE(listeners.empty());
+}
+
+TEST_F(ListenerSetTest, TakeByName) {
+    const auto unix = listen_unix(path);
+
+    auto listeners = netcore::listener_set();
+    listeners.add(dup(unix.fd()), "control");
+
+    EXPECT_FALSE(listeners.take("http").valid());
+
+    const auto taken = listeners.take("control");
+    EXPECT_TRUE(taken.valid());
+
+    if (taken.valid()) {
+        const auto server = netcore::server_socket(dup(taken));
+        const auto* const address = std::get_if<fs::path>(&server.address());
+        EXPECT_TRUE(address && *address == path);
+    }
+}
+
+TEST_F(ListenerSetTest, EnvironmentForOtherProcess) {
+    const auto pid = std::to_string(getpid() + 1);
+
+    setenv("LISTEN_PID", pid.c_str(), 1);
+    setenv("LISTEN_FDS", "1", 1);
+
+    EXPECT_TRUE(netcore::listener_set::from_environment().empty());
+    EXPECT_NE(nullptr, std::getenv("LISTEN_FDS"));
+
+    unsetenv("LISTEN_PID");
+    unsetenv("LISTEN_FDS");
+}
+
+TEST_F(ListenerSetTest, Environment) {
+    const auto pid = fork();
+    ASSERT_NE(-1, pid);
+
+    if (pid == 0) _exit(activate(path));
+
+    auto status = 0;
+    ASSERT_EQ(pid, waitpid(pid, &status, 0));
+
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+}
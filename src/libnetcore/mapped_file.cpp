@@ -0,0 +1,159 @@
+#include <netcore/file.hpp>
+#include <netcore/mapped_file.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <ext/except.h>
+#include <sys/stat.h>
+#include <timber/timber>
+#include <unistd.h>
+#include <utility>
+
+namespace netcore {
+    mapped_file::mapped_file(
+        const netcore::fd& descriptor,
+        const mapped_file_options& options
+    ) {
+        struct stat status = {};
+
+        if (::fstat(descriptor, &status) == -1) {
+            throw ext::system_error("could not stat mapped file");
+        }
+
+        length = status.st_size;
+        if (length == 0) return;
+
+        const auto flags = MAP_PRIVATE | (options.populate ? MAP_POPULATE : 0);
+        auto* const result =
+            ::mmap(nullptr, length, PROT_READ, flags, descriptor, 0);
+
+        if (result == MAP_FAILED) {
+            length = 0;
+            throw ext::system_error("failed to map file");
+        }
+
+        address = static_cast<std::byte*>(result);
+
+        TIMBER_DEBUG("file ({}) mapped {:L} bytes", int(descriptor), length);
+
+        advise(0, length, options.advice);
+    }
+
+    mapped_file::mapped_file(
+        const std::filesystem::path& path,
+        const mapped_file_options& options
+    ) :
+        mapped_file(netcore::open(path, O_RDONLY | O_CLOEXEC), options) {}
+
+    mapped_file::mapped_file(mapped_file&& other) noexcept :
+        address(std::exchange(other.address, nullptr)),
+        length(std::exchange(other.length, 0)),
+        position(std::exchange(other.position, 0)) {}
+
+    mapped_file::~mapped_file() {
+        if (address) ::munmap(address, length);
+    }
+
+    auto mapped_file::operator=(mapped_file&& other) noexcept -> mapped_file& {
+        if (std::addressof(other) != this) {
+            std::destroy_at(this);
+            std::construct_at(this, std::move(other));
+        }
+
+        return *this;
+    }
+
+    auto mapped_file::advise(std::size_t offset, std::size_t len, int advice)
+        const -> void {
+        if (!address || len == 0) return;
+
+        // madvise requires a page-aligned address.
+        static const auto page_size = std::size_t(::sysconf(_SC_PAGESIZE));
+        const auto aligned = offset - offset % page_size;
+
+        const auto result =
+            ::madvise(address + aligned, len + offset - aligned, advice);
+
+        if (result == -1) {
+            throw ext::system_error("failed to advise mapped file");
+        }
+    }
+
+    auto mapped_file::capacity() const noexcept -> std::size_t {
+        return length;
+    }
+
+    auto mapped_file::consume(std::size_t len) noexcept -> void {
+        position += std::min(len, length - position);
+    }
+
+    auto mapped_file::data() const noexcept -> std::span<const std::byte> {
+        return {address, length};
+    }
+
+    auto mapped_file::done() const noexcept -> bool {
+        return position == length;
+    }
+
+    auto mapped_file::peek() -> ext::task<std::span<const std::byte>> {
+        co_return remaining();
+    }
+
+    auto mapped_file::peek(std::size_t len)
+        -> ext::task<std::span<const std::byte>> {
+        const auto data = remaining();
+        if (len > data.size()) throw eof();
+
+        co_return data.first(len);
+    }
+
+    auto mapped_file::read() -> ext::task<std::span<const std::byte>> {
+        const auto data = remaining();
+        position = length;
+
+        co_return data;
+    }
+
+    auto mapped_file::read(std::size_t len)
+        -> ext::task<std::span<const std::byte>> {
+        if (done()) throw eof();
+
+        const auto data = remaining().first(std::min(len, length - position));
+        position += data.size();
+
+        co_return data;
+    }
+
+    auto mapped_file::read(void* dest, std::size_t len) -> ext::task<> {
+        if (len > length - position) throw eof();
+        if (len == 0) co_return;
+
+        std::memcpy(dest, address + position, len);
+        position += len;
+
+        co_return;
+    }
+
+    auto mapped_file::remaining() const noexcept
+        -> std::span<const std::byte> {
+        return data().subspan(position);
+    }
+
+    auto mapped_file::seek(std::size_t offset) noexcept -> void {
+        position = std::min(offset, length);
+    }
+
+    auto mapped_file::size() const noexcept -> std::size_t { return length; }
+
+    auto mapped_file::tell() const noexcept -> std::size_t { return position; }
+
+    auto mapped_file::try_read(void* dest, std::size_t len) noexcept -> long {
+        len = std::min(len, length - position);
+        if (len == 0) return 0;
+
+        std::memcpy(dest, address + position, len);
+        position += len;
+
+        return len;
+    }
+}
@@ -0,0 +1,73 @@
+#include <netcore/frame_reader.hpp>
+#include <netcore/mapped_file.hpp>
+#include <netcore/runtime.hpp>
+
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+    auto to_string(std::span<const std::byte> bytes) -> std::string {
+        return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+    }
+}
+
+class MappedFileTest : public testing::Test {
+protected:
+    fs::path path;
+
+    auto SetUp() -> void override {
+        path = fs::temp_directory_path() / "netcore.mapped_file.test";
+    }
+
+    auto TearDown() -> void override { fs::remove(path); }
+
+    auto write(std::string_view contents) -> void {
+        std::ofstream(path, std::ios::binary) << contents;
+    }
+};
+
+TEST_F(MappedFileTest, Read) {
+    write("hello world");
+
+    netcore::run([&]() -> ext::task<> {
+        auto file = netcore::mapped_file(path, {.populate = true});
+        EXPECT_EQ(11, file.size());
+
+        const auto hello = co_await file.peek(5);
+        EXPECT_EQ("hello", to_string(hello));
+        EXPECT_EQ(file.data().data(), hello.data());
+
+        file.consume(6);
+        EXPECT_EQ("world", to_string(co_await file.read(16)));
+        EXPECT_TRUE(file.done());
+        EXPECT_THROW(co_await file.read(1), netcore::eof);
+    }());
+}
+
+TEST_F(MappedFileTest, Frames) {
+    write(std::string("\0\0\0\5hello\0\0\0\0\0\0\0\5world", 22));
+
+    netcore::run([&]() -> ext::task<> {
+        auto file = netcore::mapped_file(path);
+        auto frames = netcore::frame_reader(file);
+
+        const auto first = co_await frames.read();
+        EXPECT_EQ("hello", to_string(first));
+        EXPECT_EQ(file.data().data() + 4, first.data());
+
+        EXPECT_EQ("", to_string(co_await frames.read()));
+        EXPECT_EQ("world", to_string(co_await frames.read()));
+        EXPECT_THROW(co_await frames.read(), netcore::eof);
+    }());
+}
+
+TEST_F(MappedFileTest, Empty) {
+    write("");
+
+    auto file = netcore::mapped_file(path);
+
+    EXPECT_EQ(0, file.size());
+    EXPECT_TRUE(file.done());
+}
@@ -0,0 +1,324 @@
+#include <netcore/multiplexed_client.hpp>
+#include <netcore/server_socket.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+    constexpr auto request_count = 16;
+
+    struct pipeline {
+        using request_type = std::uint32_t;
+        using response_type = std::uint32_t;
+
+        auto read(netcore::buffered_socket& socket)
+            -> ext::task<response_type> {
+            auto response = response_type();
+            co_await socket.read(&response, sizeof(response));
+            co_return response;
+        }
+
+        auto write(
+            netcore::buffered_socket& socket,
+            const request_type& request
+        ) -> ext::task<> {
+            co_await socket.write(&request, sizeof(request));
+        }
+    };
+
+    struct multiplex {
+        using request_type = std::uint32_t;
+        using response_type = std::uint32_t;
+
+        auto read(netcore::buffered_socket& socket)
+            -> ext::task<std::pair<std::uint64_t, response_type>> {
+            auto id = std::uint64_t();
+            auto response = response_type();
+
+            co_await socket.read(&id, sizeof(id));
+            co_await socket.read(&response, sizeof(response));
+
+            co_return std::pair(id, response);
+        }
+
+        auto write(
+            netcore::buffered_socket& socket,
+            std::uint64_t id,
+            const request_type& request
+        ) -> ext::task<> {
+            co_await socket.write(&id, sizeof(id));
+            co_await socket.write(&request, sizeof(request));
+        }
+    };
+
+    // Records how much of the write buffer earlier requests still occupy
+    // when each request is written.
+    struct queued_pipeline : pipeline {
+        std::size_t* buffered = nullptr;
+
+        auto write(
+            netcore::buffered_socket& socket,
+            const request_type& request
+        ) -> ext::task<> {
+            // Let the other requests queue up behind this one.
+            co_await netcore::yield();
+
+            *buffered = std::max(*buffered, socket.buffered());
+            co_await pipeline::write(socket, request);
+        }
+    };
+
+    template <typename Codec>
+    auto request(
+        netcore::multiplexed_client<Codec>& client,
+        std::uint32_t value
+    ) -> ext::jtask<std::uint32_t> {
+        co_return co_await client.request(value);
+    }
+
+    auto read_exactly(netcore::socket& socket, void* dest, std::size_t len)
+        -> ext::task<> {
+        auto* const bytes = static_cast<std::byte*>(dest);
+        std::size_t total = 0;
+
+        while (total < len) {
+            total += co_await socket.read(bytes + total, len - total);
+        }
+    }
+
+    auto write_all(netcore::socket& socket, const void* src, std::size_t len)
+        -> ext::task<> {
+        const auto* const bytes = static_cast<const std::byte*>(src);
+        std::size_t total = 0;
+
+        while (total < len) {
+            total += co_await socket.write(bytes + total, len - total);
+        }
+    }
+
+    auto serve(netcore::socket& socket) -> ext::jtask<> {
+        while (true) {
+            auto value = std::uint32_t();
+            auto* const bytes = reinterpret_cast<std::byte*>(&value);
+
+            const auto received = co_await socket.read(&value, sizeof(value));
+            if (received == 0) co_return;
+
+            co_await read_exactly(
+                socket,
+                bytes + received,
+                sizeof(value) - received
+            );
+
+            ++value;
+            co_await write_all(socket, &value, sizeof(value));
+        }
+    }
+}
+
+class MultiplexedClientTest : public testing::Test {
+protected:
+    netcore::server_socket listener = [] {
+        const auto addr = netcore::address("127.0.0.1", "0");
+
+        auto socket = netcore::server_socket(addr->ai_family, SOCK_STREAM, 0);
+        socket.bind(addr);
+        socket.listen(8);
+
+        return socket;
+    }();
+
+    netcore::socket server;
+
+    auto endpoint() const -> std::string {
+        auto bound = sockaddr_in();
+        auto len = socklen_t(sizeof(bound));
+        getsockname(listener.fd(), reinterpret_cast<sockaddr*>(&bound), &len);
+
+        return fmt::format("127.0.0.1:{}", ntohs(bound.sin_port));
+    }
+};
+
+TEST_F(MultiplexedClientTest, Pipeline) {
+    netcore::run([&]() -> ext::task<> {
+        auto client = netcore::multiplexed_client<pipeline>(endpoint());
+        auto requests = std::vector<ext::jtask<std::uint32_t>>();
+
+        for (auto i = 0; i < request_count; ++i) {
+            requests.push_back(request(client, i));
+        }
+
+        server = co_await listener.accept();
+
+        for (auto i = 0; i < request_count; ++i) {
+            auto value = std::uint32_t();
+            co_await read_exactly(server, &value, sizeof(value));
+
+            ++value;
+            co_await write_all(server, &value, sizeof(value));
+        }
+
+        for (auto i = 0; i < request_count; ++i) {
+            EXPECT_EQ(i + 1, co_await requests[i]);
+        }
+
+        EXPECT_EQ(1, client.size());
+    }());
+}
+
+TEST_F(MultiplexedClientTest, OutOfOrder) {
+    netcore::run([&]() -> ext::task<> {
+        auto client = netcore::multiplexed_client<multiplex>(endpoint());
+        auto requests = std::vector<ext::jtask<std::uint32_t>>();
+
+        for (auto i = 0; i < request_count; ++i) {
+            requests.push_back(request(client, i * 10));
+        }
+
+        server = co_await listener.accept();
+
+        struct frame {
+            std::uint64_t id;
+            std::uint32_t value;
+        };
+
+        auto frames = std::vector<frame>(request_count);
+
+        for (auto& f : frames) {
+            co_await read_exactly(server, &f.id, sizeof(f.id));
+            co_await read_exactly(server, &f.value, sizeof(f.value));
+        }
+
+        for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+            ++it->value;
+            co_await write_all(server, &it->id, sizeof(it->id));
+            co_await write_all(server, &it->value, sizeof(it->value));
+        }
+
+        for (auto i = 0; i < request_count; ++i) {
+            EXPECT_EQ(i * 10 + 1, co_await requests[i]);
+        }
+
+        EXPECT_EQ(1, client.size());
+    }());
+}
+
+TEST_F(MultiplexedClientTest, ConnectionFailure) {
+    netcore::run([&]() -> ext::task<> {
+        auto client = netcore::multiplexed_client<pipeline>(endpoint());
+
+        auto pending = request(client, 1);
+
+        server = co_await listener.accept();
+        server = netcore::socket();
+
+        EXPECT_THROW(co_await pending, netcore::eof);
+    }());
+}
+
+TEST_F(MultiplexedClientTest, Connections) {
+    netcore::run([&]() -> ext::task<> {
+        auto second = netcore::socket();
+        auto serving = std::vector<ext::jtask<>>();
+
+        {
+            auto client = netcore::multiplexed_client<pipeline>(
+                endpoint(),
+                {},
+                {.connections = 2}
+            );
+
+            auto requests = std::vector<ext::jtask<std::uint32_t>>();
+
+            for (auto i = 0; i < request_count; ++i) {
+                requests.push_back(request(client, i));
+            }
+
+            server = co_await listener.accept();
+            second = co_await listener.accept();
+
+            serving.push_back(serve(server));
+            serving.push_back(serve(second));
+
+            for (auto i = 0; i < request_count; ++i) {
+                EXPECT_EQ(i + 1, co_await requests[i]);
+            }
+
+            EXPECT_EQ(2, client.size());
+        }
+
+        // The servers stop once the client closes its connections.
+        for (auto& task : serving) co_await task;
+    }());
+}
+
+TEST_F(MultiplexedClientTest, SharedFlush) {
+    netcore::run([&]() -> ext::task<> {
+        auto buffered = std::size_t();
+        auto codec = queued_pipeline();
+        codec.buffered = &buffered;
+
+        auto client =
+            netcore::multiplexed_client<queued_pipeline>(endpoint(), codec);
+
+        auto requests = std::vector<ext::jtask<std::uint32_t>>();
+
+        for (auto i = 0; i < request_count; ++i) {
+            requests.push_back(request(client, i));
+        }
+
+        server = co_await listener.accept();
+
+        for (auto i = 0; i < request_count; ++i) {
+            auto value = std::uint32_t();
+            co_await read_exactly(server, &value, sizeof(value));
+
+            ++value;
+            co_await write_all(server, &value, sizeof(value));
+        }
+
+        for (auto i = 0; i < request_count; ++i) {
+            EXPECT_EQ(i + 1, co_await requests[i]);
+        }
+
+        // Every request but the last was left in the buffer for the next.
+        EXPECT_EQ(
+            (request_count - 1) * sizeof(std::uint32_t),
+            buffered
+        );
+    }());
+}
+
+TEST_F(MultiplexedClientTest, CancelledWriter) {
+    netcore::run([&]() -> ext::task<> {
+        auto buffered = std::size_t();
+        auto codec = queued_pipeline();
+        codec.buffered = &buffered;
+
+        auto client =
+            netcore::multiplexed_client<queued_pipeline>(endpoint(), codec);
+
+        auto value = std::uint32_t();
+
+        {
+            auto first = request(client, 1);
+            server = co_await listener.accept();
+
+            co_await read_exactly(server, &value, sizeof(value));
+            co_await write_all(server, &value, sizeof(value));
+            EXPECT_EQ(1, co_await first);
+        }
+
+        auto writing = request(client, 2);
+        auto waiting = request(client, 3);
+
+        // The writer that the first request leaves its flush to is
+        // cancelled while waiting for the lock.
+        waiting = ext::jtask<std::uint32_t>();
+
+        co_await read_exactly(server, &value, sizeof(value));
+        EXPECT_EQ(2, value);
+
+        co_await write_all(server, &value, sizeof(value));
+        EXPECT_EQ(2, co_await writing);
+    }());
+}
@@ -8,6 +8,8 @@ protected:
     netcore::mutex<int> mutex = 0;
 
     auto increment() -> ext::detached_task { ++*co_await mutex.lock(); }
+
+    auto increment_later() -> ext::jtask<> { ++*co_await mutex.lock(); }
 };
 
 TEST_F(Mutex, Get) {
@@ -52,3 +54,19 @@ TEST_F(Mutex, MultipleAwaiters) {
         EXPECT_EQ(10, *lock);
     }());
 }
+
+TEST_F(Mutex, CancelledAwaiter) {
+    netcore::run([&]() -> ext::task<> {
+        {
+            const auto lock = co_await mutex.lock();
+
+            auto cancelled = increment_later();
+            increment();
+
+            cancelled = ext::jtask<>();
+        }
+
+        const auto lock = co_await mutex.lock();
+        EXPECT_EQ(1, *lock);
+    }());
+}
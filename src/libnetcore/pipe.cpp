@@ -32,10 +32,14 @@ namespace netcore {
         return r;
     }
 
+    auto pipe::reader() const noexcept -> int { return read_end; }
+
     auto pipe::write() -> fd {
         const auto r = std::move(read_end);
         auto w = std::move(write_end);
 
         return w;
     }
+
+    auto pipe::writer() const noexcept -> int { return write_end; }
 }
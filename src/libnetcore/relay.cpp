@@ -0,0 +1,113 @@
+#include <netcore/pipe.hpp>
+#include <netcore/relay.hpp>
+
+#include <ext/except.h>
+#include <fcntl.h>
+#include <timber/timber>
+
+namespace {
+    constexpr auto chunk_size = std::size_t(64 * 1024);
+    constexpr auto splice_flags = SPLICE_F_MOVE | SPLICE_F_NONBLOCK;
+}
+
+namespace netcore {
+    auto relay(socket& a, socket& b, relay_counters& counters) -> ext::task<> {
+        auto exception = std::exception_ptr();
+
+        const auto transfer = [&](
+                                  socket& source,
+                                  socket& dest,
+                                  std::size_t& counter
+                              ) -> ext::jtask<> {
+            try {
+                co_await splice_to(source, dest, counter);
+            }
+            catch (...) {
+                if (!exception) exception = std::current_exception();
+
+                a.cancel();
+                b.cancel();
+            }
+        };
+
+        const auto forward = transfer(a, b, counters.a_to_b);
+        const auto backward = transfer(b, a, counters.b_to_a);
+
+        co_await forward;
+        co_await backward;
+
+        if (exception) std::rethrow_exception(exception);
+
+        TIMBER_DEBUG(
+            "relay {} <-> {} complete: {:L} bytes sent; {:L} bytes received",
+            a,
+            b,
+            counters.a_to_b,
+            counters.b_to_a
+        );
+    }
+
+    auto splice_to(socket& source, socket& dest, std::size_t& counter)
+        -> ext::task<> {
+        auto pipe = netcore::pipe();
+
+        while (true) {
+            auto pending = ::splice(
+                source.fd(),
+                nullptr,
+                pipe.writer(),
+                nullptr,
+                chunk_size,
+                splice_flags
+            );
+
+            if (pending == 0) break;
+
+            if (pending == -1) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    co_await source.await_read();
+                    continue;
+                }
+
+                throw ext::system_error(
+                    fmt::format("failed to splice data from {}", source)
+                );
+            }
+
+            while (pending > 0) {
+                const auto bytes = ::splice(
+                    pipe.reader(),
+                    nullptr,
+                    dest.fd(),
+                    nullptr,
+                    pending,
+                    splice_flags
+                );
+
+                if (bytes == -1) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                        co_await dest.await_write();
+                        continue;
+                    }
+
+                    throw ext::system_error(
+                        fmt::format("failed to splice data to {}", dest)
+                    );
+                }
+
+                pending -= bytes;
+                counter += bytes;
+
+                TIMBER_TRACE(
+                    "{} -> {} splice {:L} byte{}",
+                    source,
+                    dest,
+                    bytes,
+                    bytes == 1 ? "" : "s"
+                );
+            }
+        }
+
+        dest.end();
+    }
+}
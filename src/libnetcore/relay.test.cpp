@@ -0,0 +1,103 @@
+#include <netcore/except.hpp>
+#include <netcore/relay.hpp>
+
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+    auto start_relay(
+        netcore::socket& a,
+        netcore::socket& b,
+        netcore::relay_counters& counters
+    ) -> ext::jtask<> {
+        co_await netcore::relay(a, b, counters);
+    }
+
+    auto socket_pair() -> std::pair<netcore::socket, netcore::socket> {
+        int fds[2];
+
+        if (::socketpair(
+                AF_UNIX,
+                SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                0,
+                fds
+            ) == -1) {
+            throw ext::system_error("failed to create socket pair");
+        }
+
+        return {netcore::socket(fds[0]), netcore::socket(fds[1])};
+    }
+
+    auto read_all(netcore::socket& socket) -> ext::jtask<std::string> {
+        auto result = std::string();
+        char buffer[4096];
+
+        while (true) {
+            const auto bytes = co_await socket.read(buffer, sizeof(buffer));
+            if (bytes == 0) break;
+
+            result.append(buffer, bytes);
+        }
+
+        co_return result;
+    }
+
+    auto write_all(netcore::socket& socket, std::string_view data)
+        -> ext::task<> {
+        while (!data.empty()) {
+            const auto bytes = co_await socket.write(data.data(), data.size());
+            data.remove_prefix(bytes);
+        }
+
+        socket.end();
+    }
+}
+
+class RelayTest : public testing::Test {
+protected:
+    netcore::socket client;
+    netcore::socket client_end;
+    netcore::socket server;
+    netcore::socket server_end;
+
+    auto SetUp() -> void override {
+        std::tie(client, client_end) = socket_pair();
+        std::tie(server, server_end) = socket_pair();
+    }
+};
+
+TEST_F(RelayTest, Bidirectional) {
+    netcore::run([&]() -> ext::task<> {
+        const auto request = std::string(256 * 1024, 'a');
+        const auto response = std::string("response");
+
+        auto counters = netcore::relay_counters();
+        const auto relay = start_relay(client_end, server_end, counters);
+
+        const auto received = read_all(server);
+        co_await write_all(client, request);
+        EXPECT_EQ(request, co_await received);
+
+        const auto reply = read_all(client);
+        co_await write_all(server, response);
+        EXPECT_EQ(response, co_await reply);
+
+        co_await relay;
+
+        EXPECT_EQ(request.size(), counters.a_to_b);
+        EXPECT_EQ(response.size(), counters.b_to_a);
+    }());
+}
+
+TEST_F(RelayTest, Cancel) {
+    netcore::run([&]() -> ext::task<> {
+        auto counters = netcore::relay_counters();
+        const auto relay = start_relay(client_end, server_end, counters);
+
+        client_end.cancel();
+
+        EXPECT_THROW(co_await relay, netcore::task_canceled);
+        EXPECT_EQ(0, counters.a_to_b);
+        EXPECT_EQ(0, counters.b_to_a);
+    }());
+}
@@ -0,0 +1,125 @@
+#include <netcore/resolver.hpp>
+
+#include <algorithm>
+#include <ext/scope>
+#include <timber/timber>
+
+namespace {
+    constexpr auto default_threads = std::size_t(4);
+}
+
+namespace netcore {
+    auto resolver::current() -> resolver& {
+        auto& instance = runtime::current().default_resolver;
+        if (!instance) instance = std::make_unique<resolver>();
+        return *instance;
+    }
+
+    resolver::resolver(const resolver_options& options) :
+        owned(std::make_unique<awaitable_thread_pool>(
+            "resolver",
+            default_threads
+        )),
+        pool(owned.get()),
+        options(options) {}
+
+    resolver::resolver(
+        awaitable_thread_pool& pool,
+        const resolver_options& options
+    ) :
+        pool(&pool),
+        options(options) {}
+
+    auto resolver::clear() noexcept -> void { cache.clear(); }
+
+    auto resolver::resolve(
+        std::string_view host,
+        std::string_view port,
+        int type
+    ) -> ext::task<std::shared_ptr<const address>> {
+        auto key = fmt::format("{}\n{}\n{}", host, port, type);
+
+        while (true) {
+            if (const auto it = cache.find(key); it != cache.end()) {
+                const auto& cached = it->second;
+
+                if (clock::now() < cached.expires) {
+                    if (cached.error) std::rethrow_exception(cached.error);
+                    co_return cached.result;
+                }
+
+                cache.erase(it);
+            }
+
+            const auto it = lookups.find(key);
+            if (it == lookups.end()) break;
+
+            // The lookup already in flight will cache its result.
+            co_await detail::awaitable(it->second, nullptr);
+        }
+
+        lookups.try_emplace(key);
+
+        const auto deferred = ext::scope_exit([this, &key] {
+            auto lookup = lookups.extract(key);
+            runtime::current().enqueue(lookup.mapped());
+        });
+
+        auto value = entry();
+
+        try {
+            co_await pool->await([&] {
+                value.result =
+                    std::make_shared<const address>(host, port, type);
+            });
+
+            value.expires = clock::now() + options.ttl;
+        }
+        catch (...) {
+            value.error = std::current_exception();
+            value.expires = clock::now() + options.negative_ttl;
+        }
+
+        TIMBER_DEBUG(
+            "resolved {}:{}{}",
+            host,
+            port,
+            value.error ? " (failed)" : ""
+        );
+
+        const auto error = value.error;
+        auto result = value.result;
+
+        store(std::string(key), std::move(value));
+
+        if (error) std::rethrow_exception(error);
+        co_return result;
+    }
+
+    auto resolver::size() const noexcept -> std::size_t {
+        return cache.size();
+    }
+
+    auto resolver::store(std::string&& key, entry&& value) -> void {
+        if (cache.size() >= options.max_entries) {
+            const auto now = clock::now();
+
+            std::erase_if(cache, [now](const auto& item) {
+                return item.second.expires <= now;
+            });
+        }
+
+        if (cache.size() >= options.max_entries && !cache.empty()) {
+            // Make room by dropping the entry that would expire first.
+            cache.erase(std::min_element(
+                cache.begin(),
+                cache.end(),
+                [](const auto& a, const auto& b) {
+                    return a.second.expires < b.second.expires;
+                }
+            ));
+        }
+
+        cache.insert_or_assign(std::move(key), std::move(value));
+    }
+}
@@ -0,0 +1,130 @@
+#include <netcore/connect.hpp>
+#include <netcore/resolver.hpp>
+#include <netcore/server_socket.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+    auto resolve(netcore::resolver& resolver, std::string_view port)
+        -> ext::jtask<std::shared_ptr<const netcore::address>> {
+        co_return co_await resolver.resolve("127.0.0.1", port);
+    }
+}
+
+TEST(Resolver, Cache) {
+    netcore::run([]() -> ext::task<> {
+        auto pool = netcore::awaitable_thread_pool("resolver", 1);
+        auto resolver = netcore::resolver(pool);
+
+        const auto first = co_await resolver.resolve("127.0.0.1", "80");
+        const auto second = co_await resolver.resolve("127.0.0.1", "80");
+
+        EXPECT_EQ(first, second);
+        EXPECT_EQ(AF_INET, (*first)->ai_family);
+        EXPECT_EQ(1, resolver.size());
+    }());
+}
+
+TEST(Resolver, Coalesce) {
+    netcore::run([]() -> ext::task<> {
+        auto pool = netcore::awaitable_thread_pool("resolver", 1);
+        auto resolver = netcore::resolver(pool);
+
+        auto first = resolve(resolver, "80");
+        auto second = resolve(resolver, "80");
+
+        const auto a = co_await first;
+        const auto b = co_await second;
+
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(1, resolver.size());
+    }());
+}
+
+TEST(Resolver, Evict) {
+    netcore::run([]() -> ext::task<> {
+        auto pool = netcore::awaitable_thread_pool("resolver", 1);
+        auto resolver = netcore::resolver(pool, {.max_entries = 2});
+
+        const auto first = co_await resolver.resolve("127.0.0.1", "1");
+        const auto second = co_await resolver.resolve("127.0.0.1", "2");
+        co_await resolver.resolve("127.0.0.1", "3");
+
+        EXPECT_EQ(2, resolver.size());
+
+        // Only the entry closest to expiring made room for the new one.
+        EXPECT_EQ(second, co_await resolver.resolve("127.0.0.1", "2"));
+        EXPECT_NE(first, co_await resolver.resolve("127.0.0.1", "1"));
+    }());
+}
+
+TEST(Resolver, NegativeCache) {
+    netcore::run([]() -> ext::task<> {
+        auto pool = netcore::awaitable_thread_pool("resolver", 1);
+        auto resolver = netcore::resolver(pool);
+
+        EXPECT_THROW(
+            co_await resolver.resolve("127.0.0.1", "no such service"),
+            std::runtime_error
+        );
+        EXPECT_EQ(1, resolver.size());
+
+        EXPECT_THROW(
+            co_await resolver.resolve("127.0.0.1", "no such service"),
+            std::runtime_error
+        );
+    }());
+}
+
+TEST(Resolver, Connect) {
+    netcore::run([]() -> ext::task<> {
+        auto pool = netcore::awaitable_thread_pool("resolver", 1);
+        auto resolver = netcore::resolver(pool);
+
+        const auto addr = netcore::address("127.0.0.1", "0");
+
+        auto listener =
+            netcore::server_socket(addr->ai_family, SOCK_STREAM, 0);
+        listener.bind(addr);
+        listener.listen(1);
+
+        auto bound = sockaddr_in();
+        auto len = socklen_t(sizeof(bound));
+        getsockname(listener.fd(), reinterpret_cast<sockaddr*>(&bound), &len);
+        const auto port = std::to_string(ntohs(bound.sin_port));
+
+        const auto client = co_await netcore::connect(
+            "127.0.0.1",
+            port,
+            {.resolver = &resolver}
+        );
+        const auto server = co_await listener.accept();
+
+        EXPECT_EQ(1, resolver.size());
+    }());
+}
+
+TEST(Resolver, Default) {
+    netcore::run([]() -> ext::task<> {
+        auto& resolver = netcore::resolver::current();
+        resolver.clear();
+
+        const auto addr = netcore::address("127.0.0.1", "0");
+
+        auto listener =
+            netcore::server_socket(addr->ai_family, SOCK_STREAM, 0);
+        listener.bind(addr);
+        listener.listen(1);
+
+        auto bound = sockaddr_in();
+        auto len = socklen_t(sizeof(bound));
+        getsockname(listener.fd(), reinterpret_cast<sockaddr*>(&bound), &len);
+        const auto port = std::to_string(ntohs(bound.sin_port));
+
+        const auto client = co_await netcore::connect("127.0.0.1", port);
+        const auto server = co_await listener.accept();
+
+        // Connections made without a resolver use the runtime's.
+        EXPECT_EQ(1, resolver.size());
+    }());
+}
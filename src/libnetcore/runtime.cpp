@@ -1,9 +1,14 @@
+#include <netcore/deadline.hpp>
 #include <netcore/except.hpp>
+#include <netcore/resolver.hpp>
 #include <netcore/runtime.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <climits>
 #include <ext/except.h>
+#include <ext/scope>
 
 namespace {
     constexpr auto permanent_events = EPOLLET;
@@ -42,6 +47,13 @@ namespace netcore {
     }
 
     runtime::~runtime() {
+        // The resolver's events must be removed while this is still the
+        // current runtime.
+        default_resolver.reset();
+        release();
+
+        for (const auto& entry : deadlines) entry.second->scheduled = false;
+
         current_runtime = nullptr;
         TIMBER_TRACE("{} destroyed", *this);
     }
@@ -59,6 +71,16 @@ namespace netcore {
         TIMBER_TRACE("{} added entry ({})", *this, event->fd());
     }
 
+    auto runtime::expire() -> void {
+        const auto now = std::chrono::steady_clock::now();
+
+        while (!deadlines.empty() && deadlines.begin()->first <= now) {
+            auto* const deadline = deadlines.begin()->second;
+            deadlines.erase(deadlines.begin());
+            deadline->expire();
+        }
+    }
+
     auto runtime::modify(runtime::event* event) -> void {
         auto ev = epoll_event {
             .events = event->events | permanent_events,
@@ -78,6 +100,10 @@ namespace netcore {
         pending.enqueue(awaiters);
     }
 
+    auto runtime::release() noexcept -> void {
+        while (retired) delete std::exchange(retired, retired->next_retired);
+    }
+
     auto runtime::remove(int fd) const noexcept -> std::error_code {
         if (epoll_ctl(descriptor, EPOLL_CTL_DEL, fd, nullptr) == -1) {
             auto error = std::error_code(errno, std::generic_category());
@@ -119,7 +145,7 @@ namespace netcore {
                 descriptor,
                 events.get(),
                 max_events,
-                pending.empty() ? -1 : 0
+                timeout()
             );
 
             const auto wait_time =
@@ -139,12 +165,25 @@ namespace netcore {
                 throw ext::system_error("epoll wait failure");
             }
 
-            for (auto i = 0; i < ready; ++i) {
-                const auto& current = events[i];
-                auto& event = *static_cast<runtime::event*>(current.data.ptr);
-                event.resume(current.events);
+            {
+                dispatching = true;
+
+                const auto deferred = ext::scope_exit([this] {
+                    dispatching = false;
+                    release();
+                });
+
+                for (auto i = 0; i < ready; ++i) {
+                    const auto& current = events[i];
+                    auto* const event =
+                        static_cast<runtime::event*>(current.data.ptr);
+
+                    if (!event->retired) event->resume(current.events);
+                }
             }
 
+            expire();
+
             TIMBER_DEBUG(
                 "{} pending tasks to resume: {:L}",
                 *this,
@@ -157,6 +196,24 @@ namespace netcore {
         TIMBER_TRACE("{} stopped", *this);
     }
 
+    auto runtime::timeout() const -> int {
+        using std::chrono::ceil;
+        using std::chrono::milliseconds;
+
+        if (!pending.empty()) return 0;
+        if (deadlines.empty()) return -1;
+
+        const auto remaining = ceil<milliseconds>(
+            deadlines.begin()->first - std::chrono::steady_clock::now()
+        );
+
+        return static_cast<int>(std::clamp<milliseconds::rep>(
+            remaining.count(),
+            0,
+            INT_MAX
+        ));
+    }
+
     runtime::event::event(int fd, std::uint32_t events) noexcept :
         descriptor(fd),
         events(events) {
@@ -174,7 +231,17 @@ namespace netcore {
 
     auto runtime::event::create(int fd, std::uint32_t events) noexcept
         -> std::shared_ptr<event> {
-        return std::shared_ptr<event>(new event(fd, events));
+        return std::shared_ptr<event>(new event(fd, events), destroy);
+    }
+
+    auto runtime::event::destroy(event* e) noexcept -> void {
+        if (!current_runtime || !current_runtime->dispatching) {
+            delete e;
+            return;
+        }
+
+        e->retired = true;
+        e->next_retired = std::exchange(current_runtime->retired, e);
     }
 
     auto runtime::event::fd() const noexcept -> int { return descriptor; }
@@ -212,7 +279,9 @@ namespace netcore {
         }
 
         if ((events & EPOLLIN) && awaiting_in) awaiting_in.resume();
-        if ((events & EPOLLOUT) && awaiting_out) awaiting_out.resume();
+        if ((events & (EPOLLOUT | EPOLLERR)) && awaiting_out) {
+            awaiting_out.resume();
+        }
     }
 
     runtime::event::awaitable::awaitable(
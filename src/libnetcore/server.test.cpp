@@ -46,6 +46,44 @@ namespace {
 
         auto shutdown() -> void { TIMBER_INFO("Test server shutting down"); }
     };
+
+    struct reuse_port_context : server_context {
+        netcore::socket_options options = {.reuse_port = true};
+    };
+
+    using server_list = netcore::server_list<server_context>;
+
+    const auto make_server = [](const netcore::endpoint& config, auto& out) {
+        out = std::cref(config);
+        return netcore::server<server_context>();
+    };
+
+    const auto ignore_error = [](const netcore::endpoint&, std::exception_ptr) {
+    };
+
+    struct named_endpoint {
+        std::string name;
+        netcore::endpoint endpoint;
+    };
+
+    auto drain(
+        netcore::server<server_context>& server,
+        std::chrono::milliseconds timeout
+    ) -> ext::jtask<unsigned int> {
+        co_return co_await server.drain(timeout);
+    }
+
+    auto offer(server_list& list, netcore::socket& control)
+        -> ext::jtask<bool> {
+        co_return co_await list.handoff(control);
+    }
+
+    auto increment(netcore::socket& client, number_type number)
+        -> ext::task<number_type> {
+        co_await client.write(&number, sizeof(number_type));
+        co_await client.read(&number, sizeof(number_type));
+        co_return number;
+    }
 }
 
 class ServerTest : public Test {
@@ -113,3 +151,232 @@ TEST_F(ServerTest, ServerInfo) {
     EXPECT_TRUE(std::holds_alternative<std::monostate>(server.address()));
     EXPECT_EQ(0, server.connections());
 }
+
+TEST_F(ServerTest, FixedCapacityBuffers) {
+    connect([](netcore::socket client) -> ext::task<> {
+        constexpr auto capacity = sizeof(number_type) * 2;
+        constexpr number_type number = 7;
+
+        auto reader =
+            netcore::buffered_reader<netcore::socket, capacity>(client);
+        auto writer =
+            netcore::buffered_writer<netcore::socket, capacity>(client);
+
+        co_await writer.write(&number, sizeof(number_type));
+        co_await writer.flush();
+
+        number_type result = 0;
+        co_await reader.read(&result, sizeof(number_type));
+
+        EXPECT_EQ(number + 1, result);
+    });
+}
+
+TEST_F(ServerTest, Drain) {
+    connect([&](netcore::socket client) -> ext::task<> {
+        co_await netcore::yield();
+        EXPECT_EQ(1, server.connections());
+
+        // The connection finishing ends the drain before its deadline.
+        auto draining = drain(server, std::chrono::seconds(30));
+        EXPECT_FALSE(draining.is_ready());
+        EXPECT_FALSE(server.listening());
+
+        constexpr number_type number = 5;
+        co_await client.write(&number, sizeof(number_type));
+
+        number_type result = 0;
+        co_await client.read(&result, sizeof(number_type));
+        EXPECT_EQ(number + 1, result);
+
+        EXPECT_EQ(0, co_await draining);
+    });
+}
+
+TEST_F(ServerTest, DrainDeadline) {
+    // The client is held open, without sending a request, so that the
+    // connection outlives the drain's deadline.
+    connect([&]([[maybe_unused]] netcore::socket client) -> ext::task<> {
+        co_await netcore::yield();
+        EXPECT_EQ(1, server.connections());
+
+        auto first = drain(server, std::chrono::milliseconds(10));
+        EXPECT_THROW(
+            co_await server.drain(std::chrono::milliseconds(10)),
+            std::runtime_error
+        );
+
+        EXPECT_EQ(1, co_await first);
+    });
+}
+
+TEST(ServerOptionsTest, ReusePort) {
+    auto first = netcore::server<reuse_port_context>();
+    auto second = netcore::server<reuse_port_context>();
+
+    netcore::run([&]() -> ext::task<> {
+        const auto first_task =
+            first.listen(netcore::inet_socket {"127.0.0.1", "0"});
+        if (first_task.is_ready()) co_await first_task;
+
+        auto bound = sockaddr_in();
+        auto len = socklen_t(sizeof(bound));
+        getsockname(
+            first.listener()->fd(),
+            reinterpret_cast<sockaddr*>(&bound),
+            &len
+        );
+
+        const auto port = std::to_string(ntohs(bound.sin_port));
+
+        // Both servers share the port.
+        const auto second_task =
+            second.listen(netcore::inet_socket {"127.0.0.1", port});
+        if (second_task.is_ready()) co_await second_task;
+
+        EXPECT_TRUE(first.listening());
+        EXPECT_TRUE(second.listening());
+
+        first.close();
+        second.close();
+
+        co_await first_task;
+        co_await second_task;
+    }());
+}
+
+TEST(ServerListTest, Handoff) {
+    const auto path = fs::temp_directory_path() / "netcore.handoff.test.sock";
+    auto configs =
+        std::array<netcore::endpoint, 1> {unix_socket {.path = path}};
+
+    netcore::run([&]() -> ext::task<> {
+        int pair[2];
+        EXPECT_EQ(
+            0,
+            socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, pair)
+        );
+
+        auto old_control = netcore::socket(pair[0]);
+        auto new_control = netcore::socket(pair[1]);
+
+        auto old = co_await server_list::listen(
+            std::span<netcore::endpoint>(configs),
+            make_server,
+            ignore_error
+        );
+
+        const auto offered = offer(old, old_control);
+
+        auto next = co_await server_list::take_over(
+            new_control,
+            std::span<netcore::endpoint>(configs),
+            make_server,
+            ignore_error
+        );
+
+        EXPECT_TRUE(co_await offered);
+        co_await old.join();
+
+        // The socket file outlives the previous server.
+        EXPECT_EQ(0, old.listening());
+        EXPECT_EQ(1, next.listening());
+        EXPECT_TRUE(fs::is_socket(path));
+
+        {
+            auto client = co_await netcore::connect(configs.front());
+            EXPECT_EQ(5, co_await increment(client, 4));
+        }
+
+        next.close();
+        co_await next.join();
+        co_await netcore::yield();
+    }());
+
+    fs::remove(path);
+}
+
+TEST(ServerListTest, Threads) {
+    const auto directory = fs::temp_directory_path();
+    auto configs = std::array<netcore::endpoint, 3> {
+        unix_socket {.path = directory / "netcore.thread.1.sock"},
+        unix_socket {.path = directory / "netcore.missing" / "thread.sock"},
+        unix_socket {.path = directory / "netcore.thread.2.sock"}};
+
+    auto threads = netcore::async_thread_pool(2, 64, "server");
+    auto errors = 0;
+
+    const auto on_error = [&errors](const auto&, std::exception_ptr) {
+        ++errors;
+    };
+
+    netcore::run([&]() -> ext::task<> {
+        auto list = co_await server_list::listen(
+            std::span<netcore::endpoint>(configs),
+            make_server,
+            on_error,
+            {.threads = &threads}
+        );
+
+        EXPECT_EQ(1, errors);
+        EXPECT_EQ(2, co_await list.query_listening());
+        EXPECT_EQ(0, co_await list.query_connections());
+
+        for (const auto i : {0, 2}) {
+            auto client = co_await netcore::connect(configs[i]);
+            EXPECT_EQ(i + 1, co_await increment(client, i));
+        }
+
+        list.close();
+        co_await list.join();
+
+        EXPECT_EQ(0, co_await list.query_listening());
+    }());
+}
+
+TEST(ServerListTest, Named) {
+    const auto directory = fs::temp_directory_path();
+    const auto path = directory / "netcore.named.sock";
+    const auto unnamed = directory / "netcore.unnamed.sock";
+
+    auto configs = std::array<named_endpoint, 1> {named_endpoint {
+        .name = "http",
+        .endpoint = unix_socket {.path = unnamed}}};
+
+    const auto make_named = [](const named_endpoint& config, auto& out) {
+        out = std::cref(config.endpoint);
+        return netcore::server<server_context>();
+    };
+
+    const auto ignore = [](const named_endpoint&, std::exception_ptr) {};
+
+    auto inherited = netcore::server_socket(AF_UNIX, SOCK_STREAM, 0);
+    inherited.bind(path);
+    inherited.listen(8);
+
+    auto listeners = netcore::listener_set();
+    listeners.add(dup(inherited.fd()), "http");
+
+    netcore::run([&]() -> ext::task<> {
+        auto list = co_await server_list::listen(
+            std::span<named_endpoint>(configs),
+            make_named,
+            ignore,
+            {.listeners = &listeners}
+        );
+
+        EXPECT_TRUE(listeners.empty());
+        EXPECT_FALSE(fs::exists(unnamed));
+
+        {
+            const auto named = netcore::endpoint(unix_socket {.path = path});
+            auto client = co_await netcore::connect(named);
+            EXPECT_EQ(2, co_await increment(client, 1));
+        }
+
+        list.close();
+        co_await list.join();
+    }());
+
+    fs::remove(path);
+}
@@ -1,9 +1,44 @@
 #include <netcore/server_socket.hpp>
 
+#include <fcntl.h>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <tuple>
 
 namespace netcore {
+    server_socket::server_socket(int fd) :
+        descriptor(fd),
+        event(runtime::event::create(descriptor, EPOLLIN)) {
+        const auto flags = fcntl(descriptor, F_GETFL);
+
+        if (flags == -1 ||
+            fcntl(descriptor, F_SETFL, flags | O_NONBLOCK) == -1 ||
+            fcntl(descriptor, F_SETFD, FD_CLOEXEC) == -1) {
+            throw ext::system_error("Failed to configure server socket");
+        }
+
+        auto local = peer_address();
+        auto len = local.capacity();
+
+        if (getsockname(descriptor, local.data(), &len) == -1) {
+            throw ext::system_error("Failed to read server socket address");
+        }
+
+        local.resize(len);
+
+        switch (local.family()) {
+            case AF_INET:
+            case AF_INET6: addr = socket_addr(local.data(), len); break;
+            case AF_UNIX:
+                if (const auto path = local.path(); !path.empty()) {
+                    addr = std::filesystem::path(path);
+                }
+                break;
+        }
+
+        TIMBER_DEBUG("{} adopted with address {}", *this, addr);
+    }
+
     server_socket::server_socket(int domain, int type, int protocol) :
         descriptor(
             ::socket(domain, type | SOCK_NONBLOCK | SOCK_CLOEXEC, protocol)
@@ -14,19 +49,32 @@ namespace netcore {
         }
     }
 
+    server_socket::~server_socket() {
+        // A listener whose descriptor was shared with another process stays
+        // open after it is closed here, and so would remain registered.
+        if (event && descriptor.valid()) std::ignore = event->remove();
+    }
+
     auto server_socket::accept() -> ext::task<socket> {
-        auto client_addr = sockaddr_storage();
-        socklen_t addrlen = sizeof(client_addr);
+        auto peer = peer_address();
+        co_return co_await accept(peer);
+    }
 
+    auto server_socket::accept(peer_address& peer) -> ext::task<socket> {
         while (true) {
+            auto addrlen = peer.capacity();
+
             const auto client = ::accept4(
                 descriptor,
-                (sockaddr*) &client_addr,
+                peer.data(),
                 &addrlen,
                 SOCK_NONBLOCK | SOCK_CLOEXEC
             );
 
-            if (client != -1) co_return socket(client);
+            if (client != -1) {
+                peer.resize(addrlen);
+                co_return socket(client);
+            }
 
             if (errno == EAGAIN || errno == EWOULDBLOCK) {
                 if (!co_await event->in()) co_return socket();
@@ -90,6 +138,10 @@ namespace netcore {
 
     auto server_socket::cancel() -> void { event->cancel(); }
 
+    auto server_socket::configure(const socket_options& options) -> void {
+        netcore::configure(descriptor, options);
+    }
+
     auto server_socket::fd() const noexcept -> int { return descriptor; }
 
     auto server_socket::listen(int backlog) -> void {
@@ -1,9 +1,14 @@
+#include <netcore/deadline.hpp>
 #include <netcore/except.hpp>
 #include <netcore/socket.h>
 
+#include <array>
 #include <cstring>
 #include <ext/except.h>
 #include <iostream>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sys/epoll.h>
 #include <sys/sendfile.h>
 #include <sys/socket.h>
@@ -11,6 +16,11 @@
 #include <unistd.h>
 #include <utility>
 
+namespace {
+    // The kernel's limit on descriptors in a single message (SCM_MAX_FD).
+    constexpr auto max_fds = std::size_t(253);
+}
+
 namespace netcore {
     socket::socket(int fd) :
         descriptor(fd),
@@ -26,6 +36,24 @@ namespace netcore {
         }
     }
 
+    auto socket::await_connect() -> ext::task<bool> {
+        if (!co_await event->out()) throw task_canceled();
+
+        int error = 0;
+        auto len = socklen_t(sizeof(error));
+
+        if (getsockopt(descriptor, SOL_SOCKET, SO_ERROR, &error, &len) == -1) {
+            failure("failed to read socket error");
+        }
+
+        if (error != 0) {
+            errno = error;
+            co_return false;
+        }
+
+        co_return true;
+    }
+
     auto socket::await_read() -> ext::task<> {
         if (!co_await event->in()) throw task_canceled();
     }
@@ -34,17 +62,161 @@ namespace netcore {
         if (!co_await event->out()) throw task_canceled();
     }
 
+    auto socket::await_zerocopy() -> ext::task<> {
+        while (zerocopy_completed != zerocopy_sent) {
+            if (!read_zerocopy_completions()) co_await await_write();
+        }
+    }
+
     auto socket::cancel() noexcept -> void { event->cancel(); }
 
-    auto socket::connect(const sockaddr* addr, socklen_t len)
-        -> ext::task<bool> {
-        while (true) {
-            if (::connect(descriptor, addr, len) == 0) co_return true;
-            if (errno == EINPROGRESS) {
-                if (!co_await event->out()) throw task_canceled();
+    auto socket::cancellation() const noexcept
+        -> std::weak_ptr<runtime::event> {
+        return event;
+    }
+
+    auto socket::configure(const socket_options& options) -> void {
+        netcore::configure(descriptor, options);
+    }
+
+    auto socket::connect(
+        const sockaddr* addr,
+        socklen_t len,
+        std::optional<std::chrono::milliseconds> timeout
+    ) -> ext::task<bool> {
+        if (::connect(descriptor, addr, len) == 0) co_return true;
+        if (errno != EINPROGRESS) co_return false;
+
+        if (!timeout) co_return co_await await_connect();
+
+        auto timer = netcore::deadline();
+        auto expired = false;
+
+        timer.set(*timeout);
+
+        const auto watch = [&]() -> ext::jtask<> {
+            if (co_await timer.wait()) {
+                expired = true;
+                event->cancel();
             }
-            else co_return false;
+        };
+
+        auto watcher = watch();
+        auto connected = false;
+        auto error = 0;
+        auto exception = std::exception_ptr();
+
+        try {
+            connected = co_await await_connect();
+            if (!connected) error = errno;
+        }
+        catch (const task_canceled&) {
+            if (!expired) exception = std::current_exception();
         }
+
+        timer.disarm();
+        co_await watcher;
+
+        if (exception) std::rethrow_exception(exception);
+
+        if (expired) {
+            TIMBER_DEBUG("{} connection timed out", *this);
+            error = ETIMEDOUT;
+        }
+
+        errno = error;
+        co_return connected && !expired;
+    }
+
+    auto socket::cork(bool enable) -> bool {
+        int value = enable;
+
+        if (setsockopt(
+                descriptor,
+                IPPROTO_TCP,
+                TCP_CORK,
+                &value,
+                sizeof(value)
+            ) == -1) {
+            if (errno == EOPNOTSUPP || errno == ENOPROTOOPT) return false;
+            failure(
+                enable ? "failed to cork socket" : "failed to uncork socket"
+            );
+        }
+
+        TIMBER_TRACE("{} {}", *this, enable ? "corked" : "uncorked");
+
+        return true;
+    }
+
+    auto socket::connect_with_data(
+        const sockaddr* addr,
+        socklen_t len,
+        std::span<const std::byte> data
+    ) -> ext::task<std::optional<std::size_t>> {
+        const auto sent = ::sendto(
+            descriptor,
+            data.data(),
+            data.size(),
+            MSG_FASTOPEN | MSG_NOSIGNAL,
+            addr,
+            len
+        );
+
+        if (sent >= 0) {
+            TIMBER_DEBUG(
+                "{} sent {:L} byte{} with fast open",
+                *this,
+                sent,
+                sent == 1 ? "" : "s"
+            );
+
+            // The data is on its way with the SYN, but the connection may
+            // still be refused. Waiting for the handshake adds no delay to
+            // the data itself.
+            if (co_await await_connect()) co_return sent;
+            co_return std::nullopt;
+        }
+
+        // Without a fast open cookie, the kernel sends a plain SYN and
+        // reports that the connection is in progress.
+        if (errno == EINPROGRESS) {
+            if (co_await await_connect()) co_return 0;
+            co_return std::nullopt;
+        }
+
+        if (errno == EOPNOTSUPP) {
+            if (co_await connect(addr, len)) co_return 0;
+            co_return std::nullopt;
+        }
+
+        co_return std::nullopt;
+    }
+
+    auto socket::enable_zerocopy() -> bool {
+        if (zerocopy) return true;
+
+        int yes = 1;
+
+        if (setsockopt(
+                descriptor,
+                SOL_SOCKET,
+                SO_ZEROCOPY,
+                &yes,
+                sizeof(yes)
+            ) == -1) {
+            if (errno == EOPNOTSUPP || errno == ENOPROTOOPT) {
+                TIMBER_DEBUG("{} does not support zero-copy writes", *this);
+                return false;
+            }
+
+            throw ext::system_error("Failed to enable zero-copy writes");
+        }
+
+        zerocopy = true;
+        TIMBER_DEBUG("{} enabled zero-copy writes", *this);
+
+        return true;
     }
 
     auto socket::end() const -> void {
@@ -76,19 +248,200 @@ namespace netcore {
         co_return bytes_read;
     }
 
+    auto socket::read_zerocopy_completions() -> bool {
+        auto control = std::array<
+            char,
+            CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))>();
+
+        auto message = msghdr();
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+
+        if (::recvmsg(descriptor, &message, MSG_ERRQUEUE) == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return false;
+            failure("failed to read socket error queue");
+        }
+
+        for (auto* cmsg = CMSG_FIRSTHDR(&message); cmsg;
+             cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            if (!(cmsg->cmsg_level == SOL_IP &&
+                  cmsg->cmsg_type == IP_RECVERR) &&
+                !(cmsg->cmsg_level == SOL_IPV6 &&
+                  cmsg->cmsg_type == IPV6_RECVERR))
+                continue;
+
+            const auto* const error =
+                reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cmsg));
+
+            if (error->ee_origin != SO_EE_ORIGIN_ZEROCOPY) continue;
+
+            if (error->ee_errno != 0) {
+                errno = error->ee_errno;
+                failure("zero-copy send failure");
+            }
+
+            const auto count = error->ee_data - error->ee_info + 1;
+            zerocopy_completed += count;
+
+            TIMBER_TRACE(
+                "{} zero-copy send{} complete [{}-{}]{}",
+                *this,
+                count == 1 ? "" : "s",
+                error->ee_info,
+                error->ee_data,
+                error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED ? " (copied)" : ""
+            );
+        }
+
+        return true;
+    }
+
+    auto socket::receive_fds(
+        void* dest,
+        std::size_t len,
+        std::vector<netcore::fd>& fds
+    ) -> ext::task<std::size_t> {
+        auto control = std::array<char, CMSG_SPACE(sizeof(int) * max_fds)>();
+        auto iov = iovec {.iov_base = dest, .iov_len = len};
+
+        while (true) {
+            auto message = msghdr();
+            message.msg_iov = &iov;
+            message.msg_iovlen = 1;
+            message.msg_control = control.data();
+            message.msg_controllen = control.size();
+
+            const auto bytes =
+                ::recvmsg(descriptor, &message, MSG_CMSG_CLOEXEC);
+
+            if (bytes == -1) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    co_await await_read();
+                    continue;
+                }
+
+                failure("failed to receive data");
+            }
+
+            const auto received = fds.size();
+
+            for (auto* cmsg = CMSG_FIRSTHDR(&message); cmsg;
+                 cmsg = CMSG_NXTHDR(&message, cmsg)) {
+                if (cmsg->cmsg_level != SOL_SOCKET ||
+                    cmsg->cmsg_type != SCM_RIGHTS)
+                    continue;
+
+                const auto count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    int fd = -1;
+                    std::memcpy(
+                        &fd,
+                        CMSG_DATA(cmsg) + i * sizeof(int),
+                        sizeof(int)
+                    );
+                    fds.emplace_back(fd);
+                }
+            }
+
+            if (message.msg_flags & MSG_CTRUNC) {
+                errno = EMSGSIZE;
+                failure("file descriptors were discarded");
+            }
+
+            TIMBER_TRACE(
+                "{} recv {:L} byte{} with {:L} descriptor{}",
+                *this,
+                bytes,
+                bytes == 1 ? "" : "s",
+                fds.size() - received,
+                fds.size() - received == 1 ? "" : "s"
+            );
+
+            co_return bytes;
+        }
+    }
+
     auto socket::release()
         -> std::pair<netcore::fd, std::shared_ptr<runtime::event>> {
         return {std::move(descriptor), std::move(event)};
     }
 
+    auto socket::send_fds(
+        std::span<const int> fds,
+        const void* src,
+        std::size_t len
+    ) -> ext::task<std::size_t> {
+        if (fds.size() > max_fds) {
+            errno = EINVAL;
+            throw ext::system_error(fmt::format(
+                "cannot send more than {} file descriptors at once",
+                max_fds
+            ));
+        }
+
+        auto control = std::vector<char>(CMSG_SPACE(sizeof(int) * fds.size()));
+        auto iov = iovec {.iov_base = const_cast<void*>(src), .iov_len = len};
+
+        auto message = msghdr();
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+
+        if (!fds.empty()) {
+            message.msg_control = control.data();
+            message.msg_controllen = control.size();
+
+            auto* const cmsg = CMSG_FIRSTHDR(&message);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+            std::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+        }
+
+        while (true) {
+            const auto bytes = ::sendmsg(descriptor, &message, MSG_NOSIGNAL);
+
+            if (bytes >= 0) {
+                TIMBER_TRACE(
+                    "{} send {:L} byte{} with {:L} descriptor{}",
+                    *this,
+                    bytes,
+                    bytes == 1 ? "" : "s",
+                    fds.size(),
+                    fds.size() == 1 ? "" : "s"
+                );
+
+                co_return bytes;
+            }
+
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                failure("failed to send file descriptors");
+            }
+
+            co_await await_write();
+        }
+    }
+
     auto socket::sendfile(const netcore::fd& descriptor, std::size_t count)
         -> ext::task<> {
+        return sendfile(descriptor, 0, count);
+    }
+
+    auto socket::sendfile(
+        const netcore::fd& descriptor,
+        std::size_t offset,
+        std::size_t count
+    ) -> ext::task<> {
         auto sent = std::size_t();
-        auto offset = off_t();
+        auto position = off_t(offset);
 
         while (sent < count) {
-            const auto bytes =
-                ::sendfile(this->descriptor, descriptor, &offset, count - sent);
+            const auto bytes = ::sendfile(
+                this->descriptor,
+                descriptor,
+                &position,
+                count - sent
+            );
 
             if (bytes == -1) {
                 if (errno == EAGAIN || errno == EWOULDBLOCK) {
@@ -99,6 +452,8 @@ namespace netcore {
                 failure("sendfile failure");
             }
 
+            if (bytes == 0) throw eof();
+
             sent += bytes;
 
             TIMBER_DEBUG(
@@ -147,6 +502,31 @@ namespace netcore {
         return bytes_written;
     }
 
+    auto socket::try_writev(const iovec* iov, std::size_t count) -> long {
+        auto message = msghdr();
+        message.msg_iov = const_cast<iovec*>(iov);
+        message.msg_iovlen = count;
+
+        const auto bytes_written =
+            ::sendmsg(descriptor, &message, MSG_NOSIGNAL);
+
+        if (bytes_written >= 0) {
+            TIMBER_TRACE(
+                "{} send {:L} byte{} ({:L} buffer{})",
+                *this,
+                bytes_written,
+                bytes_written == 1 ? "" : "s",
+                count,
+                count == 1 ? "" : "s"
+            );
+        }
+        else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            failure("failed to send data");
+        }
+
+        return bytes_written;
+    }
+
     auto socket::valid() const -> bool { return descriptor.valid(); }
 
     auto socket::write(const void* src, std::size_t len)
@@ -160,4 +540,61 @@ namespace netcore {
 
         co_return bytes_written;
     }
+
+    auto socket::write_zerocopy(const void* src, std::size_t len)
+        -> ext::task<> {
+        const auto* bytes = static_cast<const std::byte*>(src);
+
+        while (len > 0) {
+            auto written = -1L;
+
+            if (zerocopy) {
+                written = ::send(
+                    descriptor,
+                    bytes,
+                    len,
+                    MSG_NOSIGNAL | MSG_ZEROCOPY
+                );
+
+                if (written >= 0) {
+                    ++zerocopy_sent;
+
+                    TIMBER_TRACE(
+                        "{} send {:L} byte{} (zero-copy)",
+                        *this,
+                        written,
+                        written == 1 ? "" : "s"
+                    );
+                }
+                else if (errno == ENOBUFS) {
+                    // Too many notifications are outstanding for the socket's
+                    // option memory: collect some, or copy if there are none.
+                    if (zerocopy_completed == zerocopy_sent) {
+                        written = try_write(bytes, len);
+                    }
+                    else {
+                        if (!read_zerocopy_completions()) {
+                            co_await await_write();
+                        }
+
+                        continue;
+                    }
+                }
+                else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    failure("failed to send data");
+                }
+            }
+            else written = try_write(bytes, len);
+
+            if (written == -1) {
+                co_await await_write();
+                continue;
+            }
+
+            bytes += written;
+            len -= written;
+        }
+
+        co_await await_zerocopy();
+    }
 }
@@ -0,0 +1,557 @@
+#include <netcore/address.hpp>
+#include <netcore/buffered_socket.hpp>
+#include <netcore/connect.hpp>
+#include <netcore/file_cache.hpp>
+#include <netcore/server_socket.hpp>
+#include <netcore/socket.h>
+#include <netcore/write_combiner.hpp>
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+    auto tcp_pair() -> ext::task<std::pair<netcore::socket, netcore::socket>> {
+        const auto addr = netcore::address("127.0.0.1", "0");
+
+        auto listener =
+            netcore::server_socket(addr->ai_family, SOCK_STREAM, 0);
+        listener.bind(addr);
+        listener.listen(1);
+
+        auto bound = sockaddr_storage();
+        auto len = socklen_t(sizeof(bound));
+        getsockname(listener.fd(), reinterpret_cast<sockaddr*>(&bound), &len);
+
+        auto client = netcore::socket(addr->ai_family, SOCK_STREAM, 0);
+        co_await client.connect(reinterpret_cast<sockaddr*>(&bound), len);
+
+        auto server = co_await listener.accept();
+
+        co_return std::pair(std::move(client), std::move(server));
+    }
+
+    auto read_all(netcore::socket& socket, std::size_t len)
+        -> ext::jtask<std::size_t> {
+        auto buffer = std::vector<std::byte>(64 * 1024);
+        std::size_t total = 0;
+
+        while (total < len) {
+            const auto bytes =
+                co_await socket.read(buffer.data(), buffer.size());
+            if (bytes == 0) break;
+
+            total += bytes;
+        }
+
+        co_return total;
+    }
+
+    auto write_frame(
+        netcore::write_combiner<netcore::socket>& combiner,
+        const std::vector<std::byte>& frame
+    ) -> ext::jtask<> {
+        co_await combiner.write(frame.data(), frame.size());
+    }
+}
+
+class SocketTest : public testing::Test {
+protected:
+    netcore::socket client;
+    netcore::socket server;
+
+    auto connect() -> ext::task<> {
+        std::tie(client, server) = co_await tcp_pair();
+    }
+};
+
+TEST_F(SocketTest, ZeroCopyWrite) {
+    netcore::run([&]() -> ext::task<> {
+        co_await connect();
+        const auto data = std::vector<std::byte>(4 * 1024 * 1024);
+
+        EXPECT_TRUE(client.enable_zerocopy());
+
+        const auto received = read_all(server, data.size());
+        co_await client.write_zerocopy(data.data(), data.size());
+        client.end();
+
+        EXPECT_EQ(data.size(), co_await received);
+    }());
+}
+
+TEST_F(SocketTest, ZeroCopyFallback) {
+    netcore::run([&]() -> ext::task<> {
+        co_await connect();
+        const auto data = std::vector<std::byte>(1024 * 1024);
+
+        const auto received = read_all(server, data.size());
+        co_await client.write_zerocopy(data.data(), data.size());
+        client.end();
+
+        EXPECT_EQ(data.size(), co_await received);
+    }());
+}
+
+TEST_F(SocketTest, SendfileRange) {
+    const auto path =
+        std::filesystem::temp_directory_path() / "netcore.sendfile.test";
+    std::ofstream(path) << "0123456789";
+
+    netcore::run([&]() -> ext::task<> {
+        co_await connect();
+
+        const auto file = netcore::file_cache::current().open(path);
+        co_await client.sendfile(file->descriptor, 3, 4);
+        client.end();
+
+        char buffer[16];
+        auto received = std::string();
+
+        while (true) {
+            const auto bytes = co_await server.read(buffer, sizeof(buffer));
+            if (bytes == 0) break;
+
+            received.append(buffer, bytes);
+        }
+
+        EXPECT_EQ("3456", received);
+    }());
+
+    std::filesystem::remove(path);
+}
+
+TEST_F(SocketTest, BufferedCork) {
+    const auto path =
+        std::filesystem::temp_directory_path() / "netcore.cork.test";
+    std::ofstream(path) << "body";
+
+    netcore::run([&]() -> ext::task<> {
+        co_await connect();
+
+        const auto corked = [](const auto& socket) {
+            int value = 0;
+            auto len = socklen_t(sizeof(value));
+            getsockopt(socket.fd(), IPPROTO_TCP, TCP_CORK, &value, &len);
+            return value != 0;
+        };
+
+        auto buffered = netcore::buffered_socket(std::move(client), 1024);
+        EXPECT_FALSE(corked(buffered));
+
+        co_await buffered.write("header", 6);
+        EXPECT_TRUE(corked(buffered));
+
+        co_await buffered.flush();
+        EXPECT_FALSE(corked(buffered));
+
+        char data[6];
+        co_await server.read(data, sizeof(data));
+        EXPECT_EQ("header", std::string_view(data, sizeof(data)));
+
+        // A response ending with a file is sent as soon as it is complete.
+        co_await buffered.write("header", 6);
+        co_await buffered.sendfile(path, 0, 4);
+        EXPECT_FALSE(corked(buffered));
+
+        char response[10];
+        std::size_t received = 0;
+
+        while (received < sizeof(response)) {
+            const auto bytes = co_await server.read(
+                response + received,
+                sizeof(response) - received
+            );
+            if (bytes == 0) break;
+
+            received += bytes;
+        }
+
+        EXPECT_EQ("headerbody", std::string_view(response, received));
+    }());
+
+    std::filesystem::remove(path);
+}
+
+TEST_F(SocketTest, WriteCombiner) {
+    netcore::run([&]() -> ext::task<> {
+        co_await connect();
+
+        constexpr auto writers = 8;
+        constexpr auto frame_size = std::size_t(256 * 1024);
+
+        auto combiner = netcore::write_combiner(client);
+        auto frames = std::vector<std::vector<std::byte>>();
+        auto tasks = std::vector<ext::jtask<>>();
+
+        for (auto i = 0; i < writers; ++i) {
+            frames.emplace_back(frame_size, std::byte(i));
+        }
+
+        const auto received = read_all(server, writers * frame_size);
+
+        for (const auto& frame : frames) {
+            tasks.push_back(write_frame(combiner, frame));
+        }
+
+        for (auto& task : tasks) co_await task;
+        EXPECT_FALSE(combiner.pending());
+
+        client.end();
+        EXPECT_EQ(writers * frame_size, co_await received);
+    }());
+}
+
+TEST_F(SocketTest, WriteCombinerHandoff) {
+    netcore::run([&]() -> ext::task<> {
+        co_await connect();
+
+        auto combiner = netcore::write_combiner(client);
+        const auto first = std::vector<std::byte>(4 * 1024 * 1024);
+        const auto second = std::vector<std::byte>(32 * 1024 * 1024);
+
+        const auto received = read_all(server, first.size() + second.size());
+
+        auto first_writer = write_frame(combiner, first);
+        auto second_writer = write_frame(combiner, second);
+
+        // The first writer returns once its own frame is written, leaving
+        // the rest of the queue to the second.
+        co_await first_writer;
+        EXPECT_TRUE(combiner.pending());
+
+        co_await second_writer;
+        EXPECT_FALSE(combiner.pending());
+
+        client.end();
+        EXPECT_EQ(first.size() + second.size(), co_await received);
+    }());
+}
+
+TEST_F(SocketTest, Watermarks) {
+    netcore::run([&]() -> ext::task<> {
+        co_await connect();
+
+        const auto chunk = std::vector<std::byte>(4096);
+        auto buffered = netcore::buffered_socket(std::move(client), 64 * 1024);
+        buffered.watermarks(16 * 1024, 48 * 1024);
+
+        std::size_t total = 0;
+
+        while (buffered.writable()) {
+            total += buffered.try_write(chunk.data(), chunk.size());
+        }
+
+        EXPECT_GE(buffered.buffered(), 48 * 1024);
+
+        const auto received = read_all(server, total);
+        co_await buffered.await_writable();
+
+        EXPECT_LE(buffered.buffered(), 16 * 1024);
+
+        co_await buffered.flush();
+        EXPECT_EQ(total, co_await received);
+    }());
+}
+
+TEST_F(SocketTest, Options) {
+    netcore::run([&]() -> ext::task<> {
+        co_await connect();
+
+        const auto get = [](const auto& socket, int level, int name) {
+            int value = 0;
+            auto len = socklen_t(sizeof(value));
+            getsockopt(socket.fd(), level, name, &value, &len);
+            return value;
+        };
+
+        client.configure({
+            .keepalive = true,
+            .keepalive_idle = std::chrono::seconds(30),
+            .nodelay = true,
+            .send_buffer = 64 * 1024,
+        });
+
+        EXPECT_EQ(1, get(client, SOL_SOCKET, SO_KEEPALIVE));
+        EXPECT_EQ(30, get(client, IPPROTO_TCP, TCP_KEEPIDLE));
+        EXPECT_EQ(1, get(client, IPPROTO_TCP, TCP_NODELAY));
+        EXPECT_LE(64 * 1024, get(client, SOL_SOCKET, SO_SNDBUF));
+        EXPECT_EQ(0, get(server, IPPROTO_TCP, TCP_NODELAY));
+    }());
+}
+
+TEST_F(SocketTest, FastOpen) {
+    // Data is only carried in the SYN if the system enables fast open for
+    // both clients and servers.
+    auto mode = 0;
+    std::ifstream("/proc/sys/net/ipv4/tcp_fastopen") >> mode;
+    const auto enabled = (mode & 0x3) == 0x3;
+
+    netcore::run([&]() -> ext::task<> {
+        const auto addr = netcore::address("127.0.0.1", "0");
+
+        auto listener =
+            netcore::server_socket(addr->ai_family, SOCK_STREAM, 0);
+        listener.configure({.fastopen = 16});
+        listener.bind(addr);
+        listener.listen(1);
+
+        auto bound = sockaddr_in();
+        auto len = socklen_t(sizeof(bound));
+        getsockname(listener.fd(), reinterpret_cast<sockaddr*>(&bound), &len);
+
+        const auto message = std::string_view("hello");
+        const auto endpoint = netcore::endpoint(netcore::inet_socket {
+            .host = "127.0.0.1",
+            .port = std::to_string(ntohs(bound.sin_port))});
+
+        const auto syn_data = [](const netcore::socket& socket) {
+            auto info = tcp_info();
+            auto len = socklen_t(sizeof(info));
+            getsockopt(socket.fd(), IPPROTO_TCP, TCP_INFO, &info, &len);
+            return (info.tcpi_options & TCPI_OPT_SYN_DATA) != 0;
+        };
+
+        // The first connection obtains a fast open cookie, which allows the
+        // second to carry its data in the SYN.
+        for (auto i = 0; i < 2; ++i) {
+            client = co_await netcore::connect_with_data(
+                endpoint,
+                std::as_bytes(std::span(message))
+            );
+            server = co_await listener.accept();
+
+            char data[5];
+            std::size_t received = 0;
+
+            while (received < sizeof(data)) {
+                received += co_await server.read(
+                    data + received,
+                    sizeof(data) - received
+                );
+            }
+
+            EXPECT_EQ(message, std::string_view(data, sizeof(data)));
+        }
+
+        if (enabled) {
+            EXPECT_TRUE(syn_data(client));
+        }
+    }());
+}
+
+TEST_F(SocketTest, ConcurrentConnect) {
+    netcore::run([&]() -> ext::task<> {
+        const auto addr = netcore::address("127.0.0.1", "0");
+
+        auto listener =
+            netcore::server_socket(addr->ai_family, SOCK_STREAM, 0);
+        listener.bind(addr);
+        listener.listen(1);
+
+        auto bound = sockaddr_in();
+        auto len = socklen_t(sizeof(bound));
+        getsockname(listener.fd(), reinterpret_cast<sockaddr*>(&bound), &len);
+        const auto port = std::to_string(ntohs(bound.sin_port));
+
+        client = co_await netcore::connect(
+            "localhost",
+            port,
+            {.attempt_delay = std::chrono::milliseconds(50)}
+        );
+        server = co_await listener.accept();
+
+        EXPECT_TRUE(client.valid());
+        EXPECT_TRUE(server.valid());
+    }());
+}
+
+TEST_F(SocketTest, ConcurrentConnectRefused) {
+    netcore::run([&]() -> ext::task<> {
+        const auto addr = netcore::address("127.0.0.1", "0");
+
+        auto unused = netcore::server_socket(addr->ai_family, SOCK_STREAM, 0);
+        unused.bind(addr);
+
+        auto bound = sockaddr_in();
+        auto len = socklen_t(sizeof(bound));
+        getsockname(unused.fd(), reinterpret_cast<sockaddr*>(&bound), &len);
+        const auto port = std::to_string(ntohs(bound.sin_port));
+
+        EXPECT_THROW(
+            co_await netcore::connect("localhost", port),
+            std::system_error
+        );
+
+        const auto message = std::string_view("hello");
+        auto error = std::error_code();
+
+        try {
+            co_await netcore::connect_with_data(
+                "localhost",
+                port,
+                std::as_bytes(std::span(message))
+            );
+        }
+        catch (const std::system_error& ex) {
+            error = ex.code();
+        }
+
+        EXPECT_EQ(ECONNREFUSED, error.value());
+    }());
+}
+
+TEST_F(SocketTest, ConnectTimeout) {
+    netcore::run([&]() -> ext::task<> {
+        const auto addr = netcore::address("127.0.0.1", "0");
+
+        // Once the accept queue is full, the listener drops new SYNs, which
+        // leaves further connection attempts pending.
+        auto listener =
+            netcore::server_socket(addr->ai_family, SOCK_STREAM, 0);
+        listener.bind(addr);
+        listener.listen(0);
+
+        auto bound = sockaddr_in();
+        auto len = socklen_t(sizeof(bound));
+        getsockname(listener.fd(), reinterpret_cast<sockaddr*>(&bound), &len);
+
+        const auto endpoint = netcore::endpoint(netcore::inet_socket {
+            .host = "127.0.0.1",
+            .port = std::to_string(ntohs(bound.sin_port))});
+        const auto options =
+            netcore::connect_options {.timeout = std::chrono::milliseconds(50)};
+
+        auto pending = std::vector<netcore::socket>();
+        auto timed_out = false;
+
+        for (auto i = 0; i < 8 && !timed_out; ++i) {
+            try {
+                pending.push_back(co_await netcore::connect(endpoint, options));
+            }
+            catch (const std::system_error& ex) {
+                EXPECT_EQ(ETIMEDOUT, ex.code().value());
+                timed_out = true;
+            }
+        }
+
+        EXPECT_TRUE(timed_out);
+    }());
+}
+
+TEST_F(SocketTest, PeerAddress) {
+    netcore::run([&]() -> ext::task<> {
+        const auto addr = netcore::address("127.0.0.1", "0");
+
+        auto listener =
+            netcore::server_socket(addr->ai_family, SOCK_STREAM, 0);
+        listener.bind(addr);
+        listener.listen(1);
+
+        auto bound = sockaddr_in();
+        auto len = socklen_t(sizeof(bound));
+        getsockname(listener.fd(), reinterpret_cast<sockaddr*>(&bound), &len);
+
+        client = netcore::socket(addr->ai_family, SOCK_STREAM, 0);
+        co_await client.connect(reinterpret_cast<sockaddr*>(&bound), len);
+
+        auto peer = netcore::peer_address();
+        server = co_await listener.accept(peer);
+
+        auto local = sockaddr_in();
+        len = sizeof(local);
+        getsockname(client.fd(), reinterpret_cast<sockaddr*>(&local), &len);
+
+        EXPECT_EQ(AF_INET, peer.family());
+        EXPECT_EQ(ntohs(local.sin_port), peer.port());
+        EXPECT_EQ(
+            fmt::format("127.0.0.1:{}", ntohs(local.sin_port)),
+            fmt::format("{}", peer)
+        );
+
+        const auto copy = peer;
+        EXPECT_EQ(peer, copy);
+        EXPECT_EQ(std::hash<netcore::peer_address>()(peer), copy.hash());
+    }());
+}
+
+TEST(PeerAddress, Host) {
+    const auto make = [](unsigned short port, unsigned char padding) {
+        auto addr = sockaddr_in();
+        std::memset(&addr, padding, sizeof(addr));
+
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        inet_pton(AF_INET, "10.0.0.1", &addr.sin_addr);
+
+        return netcore::peer_address(
+            reinterpret_cast<const sockaddr*>(&addr),
+            sizeof(addr)
+        );
+    };
+
+    const auto a = make(1000, 0);
+    const auto b = make(2000, 0);
+    const auto padded = make(1000, 0xff);
+
+    EXPECT_EQ(a, padded);
+    EXPECT_EQ(a.hash(), padded.hash());
+    EXPECT_NE(a, b);
+
+    EXPECT_TRUE(a.same_host(b));
+    EXPECT_EQ(a.host_hash(), b.host_hash());
+
+    auto hosts = std::unordered_set<
+        netcore::peer_address,
+        netcore::peer_host_hash,
+        netcore::peer_host_equal>();
+
+    hosts.insert(a);
+    hosts.insert(b);
+    EXPECT_EQ(1, hosts.size());
+}
+
+TEST_F(SocketTest, FileDescriptorPassing) {
+    netcore::run([&]() -> ext::task<> {
+        int pair[2];
+        EXPECT_EQ(
+            0,
+            socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, pair)
+        );
+
+        client = netcore::socket(pair[0]);
+        server = netcore::socket(pair[1]);
+
+        int pipe[2];
+        EXPECT_EQ(0, ::pipe(pipe));
+
+        const auto read_end = netcore::fd(pipe[0]);
+        auto write_end = netcore::fd(pipe[1]);
+
+        const int fds[] = {write_end};
+        const char message = 'x';
+        co_await client.send_fds(fds, &message, sizeof(message));
+        write_end.close();
+
+        auto received = std::vector<netcore::fd>();
+        char data = 0;
+        EXPECT_EQ(
+            1,
+            co_await server.receive_fds(&data, sizeof(data), received)
+        );
+        EXPECT_EQ(message, data);
+        EXPECT_EQ(1, received.size());
+        if (received.empty()) co_return;
+
+        EXPECT_EQ(5, ::write(received.front(), "hello", 5));
+
+        char buffer[5];
+        EXPECT_EQ(5, ::read(read_end, buffer, sizeof(buffer)));
+        EXPECT_EQ("hello", std::string_view(buffer, sizeof(buffer)));
+    }());
+}
@@ -0,0 +1,77 @@
+#include <netcore/socket_options.hpp>
+
+#include <ext/except.h>
+#include <fmt/format.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <timber/timber>
+
+namespace {
+    auto set(int fd, int level, int name, const char* description, int value)
+        -> void {
+        if (setsockopt(fd, level, name, &value, sizeof(value)) == -1) {
+            throw ext::system_error(
+                fmt::format("failed to set socket option {}", description)
+            );
+        }
+
+        TIMBER_TRACE("socket ({}) set {} = {}", fd, description, value);
+    }
+
+    template <typename T>
+    auto set(
+        int fd,
+        int level,
+        int name,
+        const char* description,
+        const std::optional<T>& value
+    ) -> void {
+        if (!value) return;
+
+        if constexpr (requires { value->count(); }) {
+            set(fd, level, name, description, value->count());
+        }
+        else set(fd, level, name, description, int(*value));
+    }
+}
+
+namespace netcore {
+    auto socket_options::accepted() const -> socket_options {
+        return {.quickack = quickack};
+    }
+
+    auto socket_options::empty() const noexcept -> bool {
+        return !(
+            busy_poll || defer_accept || fastopen || keepalive ||
+            keepalive_count || keepalive_idle || keepalive_interval ||
+            nodelay || notsent_lowat || quickack || receive_buffer ||
+            reuse_port || send_buffer
+        );
+    }
+
+    auto configure(int fd, const socket_options& options) -> void {
+        const auto sock = [fd](int name, const char* text, const auto& value) {
+            set(fd, SOL_SOCKET, name, text, value);
+        };
+
+        const auto tcp = [fd](int name, const char* text, const auto& value) {
+            set(fd, IPPROTO_TCP, name, text, value);
+        };
+
+        sock(SO_BUSY_POLL, "SO_BUSY_POLL", options.busy_poll);
+        sock(SO_KEEPALIVE, "SO_KEEPALIVE", options.keepalive);
+        sock(SO_RCVBUF, "SO_RCVBUF", options.receive_buffer);
+        sock(SO_REUSEPORT, "SO_REUSEPORT", options.reuse_port);
+        sock(SO_SNDBUF, "SO_SNDBUF", options.send_buffer);
+
+        tcp(TCP_DEFER_ACCEPT, "TCP_DEFER_ACCEPT", options.defer_accept);
+        tcp(TCP_FASTOPEN, "TCP_FASTOPEN", options.fastopen);
+        tcp(TCP_KEEPCNT, "TCP_KEEPCNT", options.keepalive_count);
+        tcp(TCP_KEEPIDLE, "TCP_KEEPIDLE", options.keepalive_idle);
+        tcp(TCP_KEEPINTVL, "TCP_KEEPINTVL", options.keepalive_interval);
+        tcp(TCP_NODELAY, "TCP_NODELAY", options.nodelay);
+        tcp(TCP_NOTSENT_LOWAT, "TCP_NOTSENT_LOWAT", options.notsent_lowat);
+        tcp(TCP_QUICKACK, "TCP_QUICKACK", options.quickack);
+    }
+}
@@ -4,6 +4,8 @@
 #include <netcore/timer.hpp>
 
 #include <gtest/gtest.h>
+#include <memory>
+#include <thread>
 
 using namespace std::chrono_literals;
 
@@ -58,3 +60,30 @@ TEST(Timer, Disarm) {
         EXPECT_TRUE(canceled);
     }());
 }
+
+TEST(Timer, DestroyedWhileReady) {
+    netcore::run([]() -> ext::task<> {
+        auto first = netcore::timer::monotonic();
+        auto second = std::make_unique<netcore::timer>(
+            netcore::timer::monotonic()
+        );
+
+        first.set(1ms);
+        second->set(1ms);
+
+        // Blocks the runtime until both timers have expired, so that they
+        // are reported together and 'second' is destroyed while its event
+        // is still to be processed.
+        const auto block = []() -> ext::jtask<> {
+            co_await netcore::yield();
+            std::this_thread::sleep_for(10ms);
+        };
+
+        auto blocking = block();
+
+        co_await first.wait();
+        second.reset();
+
+        co_await blocking;
+    }());
+}